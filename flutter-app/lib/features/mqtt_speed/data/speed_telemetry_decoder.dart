@@ -0,0 +1,98 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+/// One speed reading published by the Qt simulator.
+class SpeedSample {
+  const SpeedSample({
+    required this.vehicleId,
+    required this.timestamp,
+    required this.speed,
+  });
+
+  /// -1 for the player's vehicle, otherwise the fleet index.
+  final int vehicleId;
+  final DateTime timestamp;
+
+  /// km/h
+  final double speed;
+}
+
+/// Decodes speed telemetry in either format the simulator publishes.
+///
+/// JSON arrives on `vehicle/speed/publish` (one sample) and
+/// `vehicle/speed/batch`. The binary format arrives on the same topics with a
+/// `/bin/v1` suffix. It is little-endian: a 12-byte header (u8 version = 1,
+/// u8 flags, u16 sample count, i64 base timestamp in epoch ms) followed by
+/// 12-byte records (i32 vehicle id, i32 ms offset from the base timestamp,
+/// f32 speed in km/h). See `qt-app/include/utils/TelemetryCodec.h`.
+class SpeedTelemetryDecoder {
+  static const int binaryVersion = 1;
+  static const String binaryTopicSuffix = '/bin/v1';
+  static const int _headerSize = 12;
+  static const int _recordSize = 12;
+
+  static List<SpeedSample> decode(String topic, Uint8List payload) {
+    if (topic.endsWith(binaryTopicSuffix)) {
+      return decodeBinary(payload);
+    }
+    return decodeJson(utf8.decode(payload));
+  }
+
+  static List<SpeedSample> decodeBinary(Uint8List payload) {
+    final data = ByteData.sublistView(payload);
+    if (payload.length < _headerSize || data.getUint8(0) != binaryVersion) {
+      throw const FormatException('Unsupported speed telemetry payload');
+    }
+
+    final count = data.getUint16(2, Endian.little);
+    if (payload.length != _headerSize + count * _recordSize) {
+      throw const FormatException('Truncated speed telemetry payload');
+    }
+
+    final baseTimestamp = data.getInt64(4, Endian.little);
+    return List.generate(count, (i) {
+      final offset = _headerSize + i * _recordSize;
+      return SpeedSample(
+        vehicleId: data.getInt32(offset, Endian.little),
+        timestamp: DateTime.fromMillisecondsSinceEpoch(
+          baseTimestamp + data.getInt32(offset + 4, Endian.little),
+        ),
+        speed: data.getFloat32(offset + 8, Endian.little),
+      );
+    });
+  }
+
+  static List<SpeedSample> decodeJson(String payload) {
+    final json = jsonDecode(payload) as Map<String, dynamic>;
+
+    // A single report carries an ISO timestamp, a batch epoch milliseconds
+    final samples = json['samples'] as List<dynamic>?;
+    if (samples == null) {
+      return [
+        SpeedSample(
+          vehicleId: _vehicleIndex(json['vehicle_id'] as String),
+          timestamp: DateTime.parse(json['timestamp'] as String),
+          speed: (json['speed'] as num).toDouble(),
+        ),
+      ];
+    }
+
+    return samples.map((entry) {
+      final sample = entry as Map<String, dynamic>;
+      return SpeedSample(
+        vehicleId: _vehicleIndex(sample['vehicle_id'] as String),
+        timestamp: DateTime.fromMillisecondsSinceEpoch(sample['timestamp'] as int),
+        speed: (sample['speed'] as num).toDouble(),
+      );
+    }).toList();
+  }
+
+  // JSON names fleet vehicles "<client id>/fleet/<index>"
+  static int _vehicleIndex(String vehicleId) {
+    final marker = vehicleId.lastIndexOf('/fleet/');
+    if (marker < 0) {
+      return -1;
+    }
+    return int.tryParse(vehicleId.substring(marker + 7)) ?? -1;
+  }
+}
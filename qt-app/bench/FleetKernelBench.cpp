@@ -0,0 +1,68 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include "core/FleetKernels.h"
+#include "models/FleetModel.h"
+
+// Vehicles per second for each fleet kernel path on the same fleet.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fleet physics kernel microbenchmark");
+    parser.addHelpOption();
+    QCommandLineOption vehiclesOption("vehicles", "Fleet size.", "count", "100000");
+    QCommandLineOption stepsOption("steps", "Physics steps per path.", "count", "1000");
+    parser.addOption(vehiclesOption);
+    parser.addOption(stepsOption);
+    parser.process(app);
+    
+    int vehicles = qMax(1, parser.value(vehiclesOption).toInt());
+    int steps = qMax(1, parser.value(stepsOption).toInt());
+    
+    FleetModel fleet;
+    fleet.resize(vehicles);
+    
+    QTextStream out(stdout);
+    out << "vehicles=" << vehicles << " steps=" << steps << "\n";
+    
+    const FleetKernels::Path paths[] = {
+        FleetKernels::Path::Scalar,
+        FleetKernels::Path::Sse41,
+        FleetKernels::Path::Avx2
+    };
+    
+    for (FleetKernels::Path path : paths) {
+        if (!FleetKernels::isPathSupported(path)) {
+            out << FleetKernels::pathName(path) << ": not supported on this CPU\n";
+            continue;
+        }
+        
+        QVector<double> positions(fleet.positionsX(), fleet.positionsX() + vehicles);
+        QVector<double> speeds(fleet.speeds(), fleet.speeds() + vehicles);
+        FleetKernels::Batch batch = { positions.data(), speeds.data(),
+                                      fleet.accelerations(), fleet.maxSpeeds(), vehicles };
+        FleetKernels::Params params = { 1.0 / 240, 0.995, fleet.roadBounds().left(), fleet.roadBounds().width() };
+        
+        // Warm caches and let the clock settle before timing
+        FleetKernels::integrate(path, batch, params);
+        
+        QElapsedTimer timer;
+        timer.start();
+        double checksum = 0.0;
+        for (int step = 0; step < steps; ++step) {
+            checksum += FleetKernels::integrate(path, batch, params).speedSum;
+        }
+        double seconds = timer.nsecsElapsed() / 1e9;
+        
+        double rate = double(vehicles) * steps / seconds;
+        out << FleetKernels::pathName(path) << ": " << qRound64(rate) << " vehicles/s"
+            << " (" << seconds * 1e3 << " ms, checksum " << checksum << ")\n";
+    }
+    
+    out << "active path: " << FleetKernels::pathName(FleetKernels::activePath()) << "\n";
+    return 0;
+}
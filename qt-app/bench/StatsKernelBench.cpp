@@ -0,0 +1,128 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <cmath>
+#include <functional>
+#include "utils/StatsKernels.h"
+
+namespace {
+
+// The two-pass loops DataProcessor used before the kernels
+double naiveVariance(const QVector<double> &data)
+{
+    double sum = 0.0;
+    for (double value : data) {
+        sum += value;
+    }
+    double mean = sum / data.size();
+    double squares = 0.0;
+    for (double value : data) {
+        squares += (value - mean) * (value - mean);
+    }
+    return squares / (data.size() - 1);
+}
+
+double naiveCorrelation(const QVector<double> &x, const QVector<double> &y)
+{
+    double sumX = 0.0;
+    double sumY = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        sumX += x[i];
+        sumY += y[i];
+    }
+    double meanX = sumX / x.size();
+    double meanY = sumY / y.size();
+    double covariance = 0.0;
+    double varianceX = 0.0;
+    double varianceY = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        double dx = x[i] - meanX;
+        double dy = y[i] - meanY;
+        covariance += dx * dy;
+        varianceX += dx * dx;
+        varianceY += dy * dy;
+    }
+    return covariance / std::sqrt(varianceX * varianceY);
+}
+
+}
+
+// Samples per second for the naive statistics loops and each statistics
+// kernel path, on speed-like series (large mean, small spread, where the
+// naive sums lose the most precision).
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Statistics kernel microbenchmark");
+    parser.addHelpOption();
+    QCommandLineOption samplesOption("samples", "Comma-separated series lengths.", "counts",
+                                     "1000000,10000000,100000000");
+    QCommandLineOption repeatOption("repeat", "Runs per case; the fastest counts.", "count", "3");
+    parser.addOption(samplesOption);
+    parser.addOption(repeatOption);
+    parser.process(app);
+    
+    int repeat = qMax(1, parser.value(repeatOption).toInt());
+    QTextStream out(stdout);
+    
+    auto time = [&](const std::function<double()> &body, double &value) {
+        qint64 best = -1;
+        for (int run = 0; run < repeat; ++run) {
+            QElapsedTimer timer;
+            timer.start();
+            value = body();
+            qint64 elapsed = timer.nsecsElapsed();
+            best = best < 0 ? elapsed : qMin(best, elapsed);
+        }
+        return best / 1e9;
+    };
+    
+    for (const QString &countText : parser.value(samplesOption).split(',')) {
+        int count = countText.toInt();
+        if (count < 2) {
+            continue;
+        }
+    
+        QVector<double> speeds(count);
+        QVector<double> other(count);
+        QRandomGenerator random(42);
+        for (int i = 0; i < count; ++i) {
+            speeds[i] = 90.0 + random.generateDouble();
+            other[i] = 0.5 * speeds[i] + random.generateDouble();
+        }
+        out << "samples=" << count << "\n";
+    
+        double value = 0.0;
+        double seconds = time([&]() { return naiveVariance(speeds); }, value);
+        out << "  variance naive:  " << qRound64(count / seconds) << " samples/s (" << value << ")\n";
+        seconds = time([&]() { return naiveCorrelation(speeds, other); }, value);
+        out << "  correlation naive:  " << qRound64(count / seconds) << " samples/s (" << value << ")\n";
+    
+        const StatsKernels::Path paths[] = { StatsKernels::Path::Scalar, StatsKernels::Path::Avx2 };
+        for (StatsKernels::Path path : paths) {
+            const char *name = StatsKernels::pathName(path);
+            if (!StatsKernels::isPathSupported(path)) {
+                out << "  " << name << ": not supported on this CPU\n";
+                continue;
+            }
+            seconds = time([&]() {
+                return StatsKernels::variance(StatsKernels::moments(path, speeds.constData(), count));
+            }, value);
+            out << "  variance " << name << ":  " << qRound64(count / seconds) << " samples/s (" << value << ")\n";
+            seconds = time([&]() {
+                return StatsKernels::correlation(StatsKernels::crossMoments(path, speeds.constData(),
+                                                                            other.constData(), count));
+            }, value);
+            out << "  correlation " << name << ":  " << qRound64(count / seconds) << " samples/s (" << value << ")\n";
+        }
+    }
+    
+    out << "active path: " << StatsKernels::pathName(StatsKernels::activePath()) << "\n";
+    return 0;
+}
@@ -0,0 +1,349 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "core/GameEngine.h"
+#include "core/FleetKernels.h"
+#include "models/VehicleModel.h"
+#include "utils/DataProcessor.h"
+#include "utils/MqttFrameDecoder.h"
+#include "utils/MqttPacketEncoder.h"
+#include "utils/SpeedReportingService.h"
+#include "utils/StreamingFilters.h"
+#include "utils/TelemetryCodec.h"
+
+namespace {
+
+// Repeats one batch of work until minSeconds have passed and reports the
+// rate over all of it. batch() returns how many operations it performed.
+QJsonObject measure(const QString &name, double minSeconds, const std::function<qint64()> &batch)
+{
+    // One untimed batch warms caches and any lazy allocation
+    batch();
+    
+    qint64 operations = 0;
+    int batches = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        operations += batch();
+        ++batches;
+    } while (timer.nsecsElapsed() < qint64(minSeconds * 1e9));
+    double seconds = timer.nsecsElapsed() / 1e9;
+    
+    QJsonObject result;
+    result["name"] = name;
+    result["operations"] = operations;
+    result["batches"] = batches;
+    result["seconds"] = seconds;
+    result["ops_per_second"] = seconds > 0.0 ? operations / seconds : 0.0;
+    return result;
+}
+
+QVector<double> speedSeries(int size)
+{
+    // Noisy speed trace around a slow swing, fixed seed for repeatable runs
+    QRandomGenerator generator(42);
+    QVector<double> series(size);
+    for (int i = 0; i < size; ++i) {
+        series[i] = 90.0 + 30.0 * std::sin(i * 0.001) + generator.bounded(10.0) - 5.0;
+    }
+    return series;
+}
+
+}
+
+// Throughput of the hot paths: engine ticks, vehicle updates, MQTT packet
+// encoding and DataProcessor filters. Results are written as JSON so runs
+// can be diffed and tracked over time.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Vehicle speed simulation throughput benchmarks");
+    parser.addHelpOption();
+    QCommandLineOption outputOption("output", "Write the JSON report to a file instead of stdout.", "file");
+    QCommandLineOption durationOption("min-time", "Minimum measured time per case, in seconds.", "seconds", "1.0");
+    QCommandLineOption quickOption("quick", "Skip the largest sizes for a fast smoke run.");
+    QCommandLineOption filterOption("filter", "Only run cases whose name contains this text.", "text");
+    parser.addOption(outputOption);
+    parser.addOption(durationOption);
+    parser.addOption(quickOption);
+    parser.addOption(filterOption);
+    parser.process(app);
+    
+    double minSeconds = qMax(0.01, parser.value(durationOption).toDouble());
+    bool quick = parser.isSet(quickOption);
+    QString filter = parser.value(filterOption);
+    
+    QJsonArray results;
+    QJsonObject payloadSizes;
+    QJsonObject enqueueLatency;
+    auto run = [&](const QString &name, const std::function<qint64()> &batch) {
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            return;
+        }
+        QJsonObject result = measure(name, minSeconds, batch);
+        QTextStream(stderr) << name << ": " << qRound64(result["ops_per_second"].toDouble()) << " ops/s\n";
+        results.append(result);
+    };
+    
+    // Engine ticks through the external clock, so nothing waits on a timer
+    QVector<int> fleetSizes = { 0, 10000 };
+    if (!quick) {
+        fleetSizes.append(100000);
+    }
+    for (int fleetSize : fleetSizes) {
+        GameEngine engine;
+        engine.setExternalClockEnabled(true);
+        engine.setFleetSize(fleetSize);
+        QRectF road = engine.roadBounds();
+        int perLane = (fleetSize + engine.fleet()->laneCount() - 1) / engine.fleet()->laneCount();
+        road.setWidth(qMax(road.width(), perLane * engine.fleet()->vehicleSize().width() * 2));
+        engine.setRoadBounds(road);
+        engine.startGame();
+        engine.requestVehicleSpeed(100.0);
+    
+        double frameTime = 1.0 / 60;
+        engine.setMaxCatchUpSteps(engine.physicsRate() / 60 + 1);
+        run(QString("engine.ticks/fleet=%1").arg(fleetSize), [&]() {
+            quint64 before = engine.simulationTick();
+            for (int frame = 0; frame < 60; ++frame) {
+                engine.advanceFrame(frameTime);
+            }
+            return qint64(engine.simulationTick() - before);
+        });
+        engine.stopGame();
+    }
+    
+    {
+        VehicleModel vehicle;
+        vehicle.setSpeed(100.0);
+        run("vehicle.updates", [&]() {
+            for (int i = 0; i < 10000; ++i) {
+                vehicle.setSpeed(80.0 + (i & 63));
+                vehicle.updatePosition(1.0 / 240);
+            }
+            return qint64(10000);
+        });
+    }
+    
+    {
+        SpeedReportingService service;
+        run("mqtt.format_message", [&]() {
+            qint64 bytes = 0;
+            for (int i = 0; i < 1000; ++i) {
+                bytes += service.formatSpeedMessage(80.0 + i * 0.01).size();
+            }
+            return bytes > 0 ? qint64(1000) : qint64(0);
+        });
+    
+        // Telemetry payloads, JSON against binary, in samples per second
+        // with 64 samples packed into each message
+        QVector<SpeedSample> batch;
+        for (int i = 0; i < 64; ++i) {
+            batch.append({ i, 1700000000000 + i * 16, 80.0 + i * 0.5 });
+        }
+        QByteArray jsonPayload = service.formatBatchMessage(batch.constData(), batch.size());
+        QByteArray binaryPayload;
+        TelemetryCodec::encodeBinary(batch.constData(), batch.size(), binaryPayload);
+        payloadSizes["json/samples=64"] = jsonPayload.size();
+        payloadSizes["binary/samples=64"] = binaryPayload.size();
+        
+        run("telemetry.encode_json/samples=64", [&]() {
+            qint64 bytes = 0;
+            for (int i = 0; i < 100; ++i) {
+                bytes += service.formatBatchMessage(batch.constData(), batch.size()).size();
+            }
+            return bytes > 0 ? qint64(100 * batch.size()) : qint64(0);
+        });
+        run("telemetry.decode_json/samples=64", [&]() {
+            qint64 samples = 0;
+            for (int i = 0; i < 100; ++i) {
+                QJsonArray entries = QJsonDocument::fromJson(jsonPayload).object().value("samples").toArray();
+                for (const QJsonValue &entry : entries) {
+                    QJsonObject object = entry.toObject();
+                    samples += object.value("speed").toDouble() > 0.0 && !object.value("vehicle_id").toString().isEmpty();
+                }
+            }
+            return samples;
+        });
+        run("telemetry.encode_binary/samples=64", [&]() {
+            qint64 bytes = 0;
+            for (int i = 0; i < 100; ++i) {
+                bytes += TelemetryCodec::encodeBinary(batch.constData(), batch.size(), binaryPayload);
+            }
+            return bytes > 0 ? qint64(100 * batch.size()) : qint64(0);
+        });
+        QVector<SpeedSample> decoded;
+        run("telemetry.decode_binary/samples=64", [&]() {
+            qint64 samples = 0;
+            for (int i = 0; i < 100; ++i) {
+                TelemetryCodec::decodeBinary(binaryPayload.constData(), binaryPayload.size(), decoded);
+                samples += decoded.size();
+            }
+            return samples;
+        });
+        
+        QByteArray message = service.formatSpeedMessage(123.45);
+        QByteArray publishTopic("vehicle/speed/publish");
+        MqttPacketEncoder encoder;
+        run("mqtt.encode_publish", [&]() {
+            qint64 bytes = 0;
+            for (int i = 0; i < 1000; ++i) {
+                bytes += encoder.encodePublish(publishTopic, message);
+            }
+            return bytes > 0 ? qint64(1000) : qint64(0);
+        });
+        
+        // Inbound side: 10k PUBLISH packets arriving in MSS-sized segments,
+        // so most reads split a packet and hold several more
+        QByteArray stream;
+        encoder.encodePublish(QByteArray("vehicle/speed/alert"), message);
+        QByteArray packet = encoder.toByteArray();
+        for (int i = 0; i < 10000; ++i) {
+            stream.append(packet);
+        }
+        MqttFrameDecoder decoder;
+        run("mqtt.decode", [&]() {
+            qint64 messages = 0;
+            for (int offset = 0; offset < stream.size(); offset += 1460) {
+                decoder.append(stream.constData() + offset, qMin(1460, int(stream.size()) - offset));
+                MqttFrame frame;
+                MqttPublish publish;
+                while (decoder.next(frame) == MqttFrameDecoder::FrameReady) {
+                    messages += MqttFrameDecoder::decodePublish(frame, publish);
+                }
+            }
+            return messages;
+        });
+    }
+    
+    {
+        // Producer side of the hand-off to the reporting thread, which
+        // drains the queue concurrently as it does behind GameEngine
+        QThread reportingThread;
+        SpeedReportingService *service = new SpeedReportingService();
+        service->moveToThread(&reportingThread);
+        QObject::connect(&reportingThread, &QThread::finished, service, &QObject::deleteLater);
+        reportingThread.start();
+        
+        run("reporting.enqueue", [&]() {
+            for (int i = 0; i < 1000; ++i) {
+                service->enqueueSpeed(SpeedSample::PLAYER_VEHICLE, 80.0 + (i & 63), i);
+            }
+            return qint64(1000);
+        });
+        
+        SpeedReportingService::QueueStats stats = service->queueStats();
+        enqueueLatency["enqueued"] = qint64(stats.enqueued);
+        enqueueLatency["dropped"] = qint64(stats.dropped);
+        enqueueLatency["mean_ns"] = stats.enqueued > 0 ? double(stats.totalNanos) / stats.enqueued : 0.0;
+        enqueueLatency["max_ns"] = qint64(stats.maxNanos);
+        
+        reportingThread.quit();
+        reportingThread.wait();
+    }
+    
+    {
+        // Filters report samples processed per second, not calls
+        DataProcessor processor;
+        QVector<int> sizes = { 1000, 10000 };
+        if (!quick) {
+            sizes.append(100000);
+        }
+        const QStringList filterTypes = { "moving_average", "median", "gaussian", "kalman" };
+        for (int size : sizes) {
+            QVector<double> series = speedSeries(size);
+            for (const QString &type : filterTypes) {
+                run(QString("filter.%1/n=%2").arg(type).arg(size), [&]() {
+                    return qint64(processor.filterData(series, type).size());
+                });
+            }
+            // The real-time path: one sample at a time through persistent state
+            std::vector<std::pair<QString, std::function<StreamingFilter *()>>> streamingTypes = {
+                { "moving_average", []() { return new StreamingMovingAverage(5); } },
+                { "median", []() { return new StreamingMedian(5); } },
+                { "gaussian", []() { return new StreamingGaussian(1.0); } },
+                { "kalman", []() { return new StreamingKalman(0.01, 1.0); } }
+            };
+            for (const auto &type : streamingTypes) {
+                std::unique_ptr<StreamingFilter> streaming(type.second());
+                run(QString("filter.%1.stream/n=%2").arg(type.first).arg(size), [&]() {
+                    double last = 0.0;
+                    for (double value : series) {
+                        last = streaming->push(value);
+                    }
+                    return qint64(std::isfinite(last) ? size : 0);
+                });
+            }
+            run(QString("statistics/n=%1").arg(size), [&]() {
+                processor.calculateStatistics(series);
+                return qint64(size);
+            });
+            run(QString("percentiles/n=%1").arg(size), [&]() {
+                processor.calculatePercentiles(series, { 50.0, 90.0, 99.0 });
+                return qint64(size);
+            });
+            run(QString("pipeline/n=%1").arg(size), [&]() {
+                return qint64(processor.runPipeline(series).size());
+            });
+        }
+    }
+    
+    {
+        // Samples imported per second from a CSV written by exportToCsv()
+        DataProcessor processor;
+        QVector<int> sizes = { 100000 };
+        if (!quick) {
+            sizes.append(1000000);
+        }
+        for (int size : sizes) {
+            QTemporaryFile csv;
+            if (!csv.open() || !processor.exportToCsv(speedSeries(size), csv.fileName())) {
+                continue;
+            }
+            run(QString("import.csv/n=%1").arg(size), [&]() {
+                return qint64(processor.importFromCsv(csv.fileName()).size());
+            });
+        }
+    }
+    
+    QJsonObject report;
+    report["benchmark"] = "vss_bench";
+    report["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    report["min_seconds"] = minSeconds;
+    report["fleet_kernel"] = QString(FleetKernels::pathName(FleetKernels::activePath()));
+    report["payload_bytes"] = payloadSizes;
+    if (!enqueueLatency.isEmpty()) {
+        report["reporting_enqueue"] = enqueueLatency;
+    }
+    report["results"] = results;
+    QByteArray json = QJsonDocument(report).toJson();
+    
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly)) {
+            QTextStream(stderr) << "Cannot write " << file.fileName() << ": " << file.errorString() << "\n";
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "utils/MqttFrameDecoder.h"
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct DecodedFrame {
+    quint8 header;
+    std::string body;
+};
+
+// Decodes the input fed in pieces of the given sizes, cycling through them.
+// Returns false if the stream turned out to be malformed.
+bool decodeAll(const uint8_t *data, size_t size, const std::vector<int> &pieces,
+               std::vector<DecodedFrame> &frames)
+{
+    MqttFrameDecoder decoder(64 * 1024);
+    size_t offset = 0;
+    size_t piece = 0;
+    MqttFrameDecoder::Status status = MqttFrameDecoder::NeedMoreData;
+    
+    while (offset < size) {
+        int chunk = int(qMin<size_t>(size_t(pieces[piece++ % pieces.size()]), size - offset));
+        decoder.append(reinterpret_cast<const char *>(data) + offset, chunk);
+        offset += chunk;
+        
+        MqttFrame frame;
+        while ((status = decoder.next(frame)) == MqttFrameDecoder::FrameReady) {
+            frames.push_back({ frame.header, std::string(frame.body, size_t(frame.bodySize)) });
+            
+            MqttPublish publish;
+            if (MqttFrameDecoder::decodePublish(frame, publish)) {
+                if (publish.topic < frame.body || publish.payload + publish.payloadSize > frame.body + frame.bodySize) {
+                    abort();
+                }
+            }
+        }
+        if (status == MqttFrameDecoder::Malformed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+// libFuzzer entry point. Decoding must not depend on how the stream was
+// split into reads: one large read and many small ones have to produce the
+// same frames and the same verdict.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 2) {
+        return 0;
+    }
+    
+    // The first two bytes choose the read sizes, the rest is the stream
+    std::vector<int> pieces = { 1 + data[0] % 7, 1 + data[1] * 4 };
+    data += 2;
+    size -= 2;
+    
+    std::vector<DecodedFrame> whole;
+    std::vector<DecodedFrame> split;
+    bool wholeValid = decodeAll(data, size, { int(qMax<size_t>(size, 1)) }, whole);
+    bool splitValid = decodeAll(data, size, pieces, split);
+    
+    if (wholeValid != splitValid || whole.size() != split.size()) {
+        abort();
+    }
+    for (size_t i = 0; i < whole.size(); ++i) {
+        if (whole[i].header != split[i].header || whole[i].body != split[i].body) {
+            abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef COLLISIONDETECTOR_H
+#define COLLISIONDETECTOR_H
+
+#include <QVector>
+#include <QPair>
+#include <QRectF>
+#include <functional>
+#include "SpatialGrid.h"
+
+class FleetModel;
+class WorkStealingThreadPool;
+
+// One frame's worth of contacts. Fleet vehicles are identified by their
+// FleetModel index; the player vehicle is PLAYER_VEHICLE.
+struct CollisionReport {
+    QVector<QPair<int, int>> vehiclePairs;
+    QVector<int> offRoadVehicles;
+    bool playerOffRoad = false;
+    
+    bool isEmpty() const { return vehiclePairs.isEmpty() && offRoadVehicles.isEmpty() && !playerOffRoad; }
+};
+
+// Broad phase over a SpatialGrid whose cells are at least one vehicle
+// long, so any overlapping pair sits in the same or an adjacent cell.
+// Queries run over fixed chunks and are concatenated in chunk order,
+// which keeps the pair order independent of the thread count.
+class CollisionDetector
+{
+public:
+    CollisionDetector();
+
+    static const int PLAYER_VEHICLE;
+    
+    void setThreadPool(WorkStealingThreadPool *pool) { m_threadPool = pool; }
+    void setRoadBounds(const QRectF &bounds) { m_roadBounds = bounds; }
+    QRectF roadBounds() const { return m_roadBounds; }
+    
+    void updateFleet(const FleetModel &fleet);
+    void detectFleet(const FleetModel &fleet, CollisionReport &report);
+    void detectPlayer(const FleetModel &fleet, const QRectF &playerBounds, CollisionReport &report) const;
+    
+    const SpatialGrid &grid() const { return m_grid; }
+
+private:
+    SpatialGrid m_grid;
+    WorkStealingThreadPool *m_threadPool;
+    QRectF m_roadBounds;
+    
+    QVector<quint64> m_cellKeys;
+    QVector<QVector<QPair<int, int>>> m_chunkPairs;
+    QVector<QVector<int>> m_chunkOffRoad;
+    
+    void forChunks(int count, const std::function<void(int)> &body);
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef FLEETKERNELS_H
+#define FLEETKERNELS_H
+
+// Batch physics kernels for FleetModel. Every path performs the same IEEE
+// operations in the same order, so positions and speeds are bit-identical
+// whichever path runs; only the speed sum may differ in its last bits
+// because the vector paths add lanes in a different order.
+namespace FleetKernels
+{
+
+enum class Path {
+    Scalar,
+    Sse41,
+    Avx2
+};
+
+struct Batch {
+    double *positionX;
+    double *speed;
+    const double *acceleration;
+    const double *maxSpeed;
+    int count;
+};
+
+struct Params {
+    double deltaTime;
+    double frictionFactor;
+    double trackStart;
+    double trackLength;
+};
+
+struct Result {
+    double speedSum;
+    double topSpeed;
+};
+
+bool isPathSupported(Path path);
+Path bestSupportedPath();
+Path activePath();
+void setActivePath(Path path);
+const char *pathName(Path path);
+
+Result integrate(const Batch &batch, const Params &params);
+Result integrate(Path path, const Batch &batch, const Params &params);
+
+}
+
+#endif
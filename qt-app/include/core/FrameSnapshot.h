@@ -0,0 +1,36 @@
+#ifndef FRAMESNAPSHOT_H
+#define FRAMESNAPSHOT_H
+
+#include <QMetaType>
+#include <QPointF>
+
+// Everything views and reporters need from one rendered frame, published
+// as a single value instead of a signal per changed property. The change
+// mask says which parts moved since the previous frame, or, for a snapshot
+// read through GameEngine::latestSnapshot(), since that reader's last read.
+struct FrameSnapshot {
+    enum Change : quint32 {
+        VehiclePositionChanged = 0x01,
+        VehicleSpeedChanged = 0x02,
+        FleetChanged = 0x04
+    };
+    static const int CHANGE_BIT_COUNT = 3;
+    
+    quint32 changes = 0;
+    quint64 tick = 0;
+    double simulationTime = 0.0;
+    double interpolationAlpha = 0.0;
+    
+    QPointF vehiclePosition;
+    double vehicleSpeed = 0.0;
+    
+    int fleetSize = 0;
+    double fleetAverageSpeed = 0.0;
+    double fleetTopSpeed = 0.0;
+    
+    bool hasChanged(Change change) const { return changes & change; }
+};
+
+Q_DECLARE_METATYPE(FrameSnapshot)
+
+#endif
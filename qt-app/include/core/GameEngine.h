@@ -4,9 +4,21 @@
 #include <QObject>
 #include <QTimer>
 #include <QElapsedTimer>
+#include <atomic>
+#include <memory>
 #include "../models/VehicleModel.h"
+#include "../models/FleetModel.h"
+#include "CollisionDetector.h"
+#include "SimulationInput.h"
+#include "FrameSnapshot.h"
+#include "TripleBuffer.h"
 #include "../utils/SpeedReportingService.h"
 
+class QThread;
+class WorkStealingThreadPool;
+class SessionRecorder;
+struct SessionHeader;
+
 class GameEngine : public QObject
 {
     Q_OBJECT
@@ -22,7 +34,28 @@ public:
     void resumeGame();
     
     VehicleModel* vehicle() const { return m_vehicle; }
+    FleetModel* fleet() const { return m_fleet; }
+    void setFleetSize(int vehicleCount);
+    void setWorkerThreadCount(int count);
+    int workerThreadCount() const { return m_workerThreadCount; }
+    // Lives on its own thread: connect to it or invoke it queued, except for
+    // enqueueSpeed()
     SpeedReportingService* speedReportingService() const { return m_speedReportingService; }
+    // Also enqueue fleet vehicles' changed speeds, under their fleet index,
+    // a bounded slice of the fleet per frame. Set before the engine moves
+    // to its own thread.
+    void setFleetReportingEnabled(bool enabled) { m_fleetReporting = enabled; }
+    bool isFleetReportingEnabled() const { return m_fleetReporting; }
+    
+    void requestVehicleSpeed(double speed);
+    void accelerateVehicle();
+    void decelerateVehicle();
+    void requestVehiclePosition(const QPointF &position);
+    void queueInput(const SimulationInput &input);
+    
+    void setSessionRecorder(SessionRecorder *recorder) { m_sessionRecorder = recorder; }
+    SessionRecorder* sessionRecorder() const { return m_sessionRecorder; }
+    void replayStep(double deltaTime);
    
     
     void update(double deltaTime);
@@ -30,12 +63,39 @@ public:
     
     void updatePhysics(double deltaTime);
     void checkCollisions();
+    void setRoadBounds(const QRectF &bounds);
+    QRectF roadBounds() const { return m_collisionDetector.roadBounds(); }
     
     void setSpeedMultiplier(double multiplier);
     double speedMultiplier() const { return m_speedMultiplier; }
     
     void setGameSpeed(double speed);
     double gameSpeed() const { return m_gameSpeed; }
+    
+    void setFixedTimestepEnabled(bool enabled);
+    bool isFixedTimestepEnabled() const { return m_fixedTimestepEnabled; }
+    void setPhysicsRate(int hz);
+    int physicsRate() const { return m_physicsRate; }
+    void setMaxCatchUpSteps(int steps);
+    int maxCatchUpSteps() const { return m_maxCatchUpSteps; }
+    
+    void setExternalClockEnabled(bool enabled);
+    bool isExternalClockEnabled() const { return m_externalClock; }
+    void advanceFrame(double frameTime);
+    quint64 simulationTick() const { return m_simulationTick; }
+    double simulationTime() const { return m_simulationTime; }
+    double droppedTime() const { return m_droppedTime; }
+    double interpolationAlpha() const { return m_interpolationAlpha; }
+    QPointF interpolatedVehiclePosition() const;
+    
+    // Each view reading snapshots keeps its own cursor, so one reader never
+    // consumes the change flags another has yet to see
+    struct SnapshotCursor {
+        quint64 frame = 0;
+    };
+    // The newest published snapshot, with the changes since this cursor's
+    // last read. Call only from the thread that owns the views.
+    FrameSnapshot latestSnapshot(SnapshotCursor &cursor);
 
 signals:
     void gameStarted();
@@ -44,20 +104,25 @@ signals:
     void gameResumed();
     void collisionDetected();
     void vehicleOffRoad();
+    void collisionsDetected(const QVector<QPair<int, int>> &vehiclePairs);
+    void vehiclesOffRoad(const QVector<int> &fleetIndices);
     void speedChanged(double speed);
+    void frameReady(const FrameSnapshot &snapshot);
 
 private slots:
     void gameLoop();
-    void onVehiclePositionChanged(const QPointF &position);
-    void onVehicleSpeedChanged(double speed);
 
 private:
     VehicleModel *m_vehicle;
+    FleetModel *m_fleet;
     SpeedReportingService *m_speedReportingService;
+    QThread *m_reportingThread;
     
     
-    bool m_isRunning;
-    bool m_isPaused;
+    // Read from the GUI thread while the engine runs on its own
+    std::atomic<bool> m_isRunning;
+    std::atomic<bool> m_isPaused;
+    bool m_externalClock;
     
     QTimer *m_gameTimer;
     QElapsedTimer *m_elapsedTimer;
@@ -67,13 +132,74 @@ private:
     double m_speedMultiplier;
     int m_targetFPS;
     
+    // Fixed-step mode: physics advances in m_fixedTimeStep increments drawn
+    // from the accumulator, independent of the UI timer interval.
+    bool m_fixedTimestepEnabled;
+    int m_physicsRate;
+    double m_fixedTimeStep;
+    int m_maxCatchUpSteps;
+    double m_accumulator;
+    double m_interpolationAlpha;
+    double m_droppedTime;
+    quint64 m_simulationTick;
+    double m_simulationTime;
+    QPointF m_previousVehiclePosition;
+    
+    // render() publishes every frame, numbered, along with the frame each
+    // change flag was last raised on; readers compare that against their
+    // cursor. Neither the engine nor the views ever wait on the other, and
+    // a read after any stall returns the newest frame.
+    struct PublishedFrame {
+        FrameSnapshot snapshot;
+        quint64 frame = 0;
+        quint64 changedOn[FrameSnapshot::CHANGE_BIT_COUNT] = {};
+    };
+    PublishedFrame m_publishedFrame;
+    TripleBuffer<PublishedFrame> m_snapshotBuffer;
+    
+    // Fleet reports walk the fleet round-robin from m_fleetReportCursor and
+    // only enqueue speeds that differ from the last one enqueued, so a
+    // fleet far larger than the report queue never floods it.
+    bool m_fleetReporting;
+    int m_fleetReportCursor;
+    QVector<double> m_reportedFleetSpeeds;
+    
+    // Fleet steps taken during a fixed-step frame are batched and handed to
+    // the worker pool once per frame. A batch runs while the engine waits
+    // for its next frame; that frame collects it and checks collisions on
+    // it before starting its own, so fleet checks and penalties land on the
+    // same steps whatever the thread count.
+    std::unique_ptr<WorkStealingThreadPool> m_threadPool;
+    int m_workerThreadCount;
+    bool m_batchFleetSteps;
+    int m_pendingFleetSteps;
+    
+    // Collisions are checked once per frame against the latest fleet
+    // snapshot; the fleet pass only reruns when its positions have moved.
+    CollisionDetector m_collisionDetector;
+    quint64 m_checkedFleetVersion;
+    bool m_playerOffRoad;
+    
+    // Inputs wait for the next step boundary so a recorder can tag them
+    // with the tick they took effect on.
+    QVector<SimulationInput> m_pendingInputs;
+    SessionRecorder *m_sessionRecorder;
+    
     double m_gravity;
     double m_friction;
     
     void initializeGame();
-    void setupConnections();
+    void stepSimulation(double deltaTime);
+    double frictionFactor(double deltaTime) const;
+    void syncFleet();
+    void flushFleetSteps();
     void updateGameObjects(double deltaTime);
     void handleVehicleOffRoad();
+    void keepVehicleInView();
+    void applyInput(const SimulationInput &input);
+    void applyPendingInputs();
+    void reportFleetSpeeds(qint64 timestamp);
+    SessionHeader sessionHeader() const;
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef SESSIONPLAYER_H
+#define SESSIONPLAYER_H
+
+#include <QByteArray>
+#include <QPointF>
+#include <QString>
+#include "SessionRecorder.h"
+
+class GameEngine;
+
+// Re-runs a session written by SessionRecorder. The engine is rebuilt from
+// the header and stepped tick by tick as fast as possible, feeding inputs
+// back on their original tick. After every step the player vehicle is
+// compared bit for bit against the log; the first divergent tick is kept
+// so a mismatch can be bisected.
+class SessionPlayer
+{
+public:
+    SessionPlayer();
+    
+    bool open(const QString &path);
+    QString errorString() const { return m_errorString; }
+    const SessionHeader &header() const { return m_header; }
+    
+    void configure(GameEngine &engine) const;
+    bool replay(GameEngine &engine);
+    
+    quint64 ticksReplayed() const { return m_ticksReplayed; }
+    quint64 inputsReplayed() const { return m_inputsReplayed; }
+    quint64 divergentTicks() const { return m_divergentTicks; }
+    quint64 firstDivergentTick() const { return m_firstDivergentTick; }
+
+private:
+    QByteArray m_data;
+    int m_offset;
+    bool m_truncated;
+    QString m_errorString;
+    SessionHeader m_header;
+    
+    QPointF m_expectedPosition;
+    double m_expectedSpeed;
+    quint64 m_ticksReplayed;
+    quint64 m_inputsReplayed;
+    quint64 m_divergentTicks;
+    quint64 m_firstDivergentTick;
+    
+    void stepTo(GameEngine &engine, quint64 tick);
+    void step(GameEngine &engine, double deltaTime);
+    
+    quint8 readByte();
+    quint16 readUInt16();
+    quint32 readUInt32();
+    double readDouble();
+    quint64 readVarint();
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include "SimulationInput.h"
+
+// Everything needed to rebuild the engine a session started from.
+struct SessionHeader {
+    int physicsRate = 60;
+    QPointF vehiclePosition;
+    double vehicleSpeed = 0.0;
+    int fleetSize = 0;
+    quint32 fleetSeed = 1;
+    int laneCount = 3;
+    QRectF roadBounds;
+};
+
+// Session log layout, all little-endian:
+//
+//   "VSSR" u16 version, then the header fields in declaration order
+//   (ints as u32, doubles as IEEE-754 f64), followed by records:
+//
+//   u8 kind, varint tick delta from the previous record, then
+//     Input: u8 type, f64 x, and f64 y for SetPosition only
+//     State: u8 mask, then for each set bit f64 step, position x,
+//            position y, speed - the fields that differ from the
+//            previous state (the step only when it is not the fixed one)
+//     End:   nothing
+//
+// Input ticks count the steps completed before the input applied; state
+// ticks count them after the step. Ticks with no change write nothing.
+class SessionRecorder
+{
+public:
+    enum RecordKind : quint8 {
+        InputRecord = 1,
+        StateRecord = 2,
+        EndRecord = 3
+    };
+    
+    enum StateField : quint8 {
+        StepField = 0x01,
+        PositionXField = 0x02,
+        PositionYField = 0x04,
+        SpeedField = 0x08
+    };
+    
+    static const quint32 MAGIC;
+    static const quint16 VERSION;
+    
+    SessionRecorder();
+    ~SessionRecorder();
+    
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+    qint64 bytesWritten() const { return m_bytesWritten + m_buffer.size(); }
+    
+    void beginSession(const SessionHeader &header);
+    void recordInput(quint64 tick, const SimulationInput &input);
+    void recordState(quint64 tick, double deltaTime, const QPointF &position, double speed);
+    void endSession(quint64 tick);
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    qint64 m_bytesWritten;
+    bool m_sessionOpen;
+    
+    quint64 m_lastTick;
+    double m_fixedTimeStep;
+    QPointF m_lastPosition;
+    double m_lastSpeed;
+    
+    void writeRecord(RecordKind kind, quint64 tick);
+    void writeByte(quint8 value);
+    void writeUInt16(quint16 value);
+    void writeUInt32(quint32 value);
+    void writeDouble(double value);
+    void writeVarint(quint64 value);
+    void flush();
+};
+
+#endif
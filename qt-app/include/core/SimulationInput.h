@@ -0,0 +1,22 @@
+#ifndef SIMULATIONINPUT_H
+#define SIMULATIONINPUT_H
+
+#include <QtGlobal>
+
+// A control input for the player vehicle. While the game runs, inputs are
+// queued and applied at the start of the next physics step, so a recorded
+// session replays each of them on exactly the same tick.
+struct SimulationInput {
+    enum Type : quint8 {
+        SetSpeed = 1,
+        Accelerate = 2,
+        Decelerate = 3,
+        SetPosition = 4
+    };
+    
+    Type type;
+    double x;
+    double y;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QHash>
+#include <QVector>
+
+// Uniform grid over an unbounded plane. Only occupied cells are stored.
+// update() moves just the items whose cell changed since the last call, so
+// a step where most vehicles stay in their cell costs little more than
+// recomputing the keys.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(double cellSize = 64.0);
+
+    void setCellSize(double size);
+    double cellSize() const { return m_cellSize; }
+    void clear();
+    
+    int itemCount() const { return m_itemCell.size(); }
+    int occupiedCellCount() const { return m_cells.size(); }
+    
+    quint64 cellKey(double x, double y) const;
+    static quint64 packKey(qint32 cellX, qint32 cellY);
+    static qint32 keyCellX(quint64 key) { return qint32(quint32(key >> 32)); }
+    static qint32 keyCellY(quint64 key) { return qint32(quint32(key)); }
+    
+    int update(const quint64 *cellKeys, int count);
+    const QVector<int> *itemsInCell(quint64 key) const;
+
+private:
+    void insert(int item, quint64 key);
+    void remove(int item);
+    
+    double m_cellSize;
+    double m_inverseCellSize;
+    QHash<quint64, QVector<int>> m_cells;
+    QVector<quint64> m_itemCell;
+    QVector<int> m_itemSlot;
+};
+
+#endif
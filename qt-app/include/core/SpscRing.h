@@ -0,0 +1,80 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <QVector>
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer/single-consumer queue. tryPush() may only be
+// called from one thread and tryPop() from one other thread; both are
+// wait-free. Neither side blocks: a full ring refuses the push and an
+// empty one the pop. Each side keeps a cached copy of the other's index
+// so the shared cache lines are only read when the cache runs out.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(int capacity = 16)
+        : m_mask(0)
+        , m_head(0)
+        , m_cachedTail(0)
+        , m_tail(0)
+        , m_cachedHead(0)
+    {
+        size_t size = 2;
+        while (size < size_t(capacity)) {
+            size <<= 1;
+        }
+        m_slots.resize(int(size));
+        m_mask = size - 1;
+    }
+    
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+    
+    int capacity() const { return m_slots.size(); }
+    
+    bool tryPush(const T &value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask) {
+                return false;
+            }
+        }
+        
+        m_slots[int(head & m_mask)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool tryPop(T &value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+        
+        value = m_slots[int(tail & m_mask)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static const size_t CACHE_LINE_SIZE = 64;
+    
+    QVector<T> m_slots;
+    size_t m_mask;
+    
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    size_t m_cachedTail;
+    
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+    size_t m_cachedHead;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+// Latest-value handoff between one writer thread and one reader thread.
+// The writer fills a back slot and swaps it with the middle one; the reader
+// swaps the middle slot to the front whenever a fresh value is waiting.
+// Both sides are wait-free and neither ever waits for the other: the writer
+// overwrites values the reader never got to, and the reader always gets
+// the newest value published, however long it was away.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : m_back(0)
+        , m_middle(1)
+        , m_front(2)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    void publish(const T &value)
+    {
+        m_slots[m_back] = value;
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // The reference stays valid until the next call to latest()
+    const T &latest()
+    {
+        if (m_middle.load(std::memory_order_relaxed) & FRESH) {
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return m_slots[m_front];
+    }
+
+private:
+    static const size_t CACHE_LINE_SIZE = 64;
+    static const int INDEX_MASK = 0x3;
+    static const int FRESH = 0x4;
+
+    T m_slots[3];
+
+    alignas(CACHE_LINE_SIZE) int m_back;
+    alignas(CACHE_LINE_SIZE) std::atomic<int> m_middle;
+    alignas(CACHE_LINE_SIZE) int m_front;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef WORKSTEALINGTHREADPOOL_H
+#define WORKSTEALINGTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool where every worker owns a task deque. Workers pop their
+// own work LIFO and steal from the other end of a sibling's deque when they
+// run dry. A thread blocked in parallelFor() runs queued tasks while it
+// waits, so nested parallelFor() calls from inside a task cannot deadlock.
+class WorkStealingThreadPool
+{
+public:
+    explicit WorkStealingThreadPool(int threadCount);
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+    WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+    int threadCount() const { return int(m_threads.size()); }
+    
+    void submit(std::function<void()> task);
+    void parallelFor(int count, const std::function<void(int)> &body);
+
+private:
+    using Task = std::function<void()>;
+    
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    int currentWorkerIndex() const;
+    void push(int queueIndex, Task task);
+    void wakeWorkers(int taskCount);
+    bool popLocal(int index, Task &task);
+    bool steal(int thief, Task &task);
+    bool runPendingTask(int self);
+    void workerLoop(int index);
+    
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<int> m_pending;
+    std::atomic<unsigned> m_nextQueue;
+    bool m_stopping;
+};
+
+#endif
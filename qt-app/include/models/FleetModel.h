@@ -0,0 +1,104 @@
+#ifndef FLEETMODEL_H
+#define FLEETMODEL_H
+
+#include <QObject>
+#include <QVector>
+#include <QRectF>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include "../core/FleetKernels.h"
+
+class WorkStealingThreadPool;
+
+// Structure-of-arrays state for large simulated fleets. Vehicles here are
+// plain array slots, not QObjects: nothing is emitted per vehicle, only one
+// aggregated fleetUpdated() per published frame.
+//
+// Physics runs over fixed-size chunks, on a thread pool when one is set.
+// Chunking and the order aggregates are combined in do not depend on the
+// thread count, so results are identical with any number of workers.
+// beginSteps() simulates into a back buffer; the readers of positionsX()
+// and speeds() only see it once collectSteps() swaps it in whole.
+class FleetModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FleetModel(QObject *parent = nullptr);
+    ~FleetModel();
+
+    int vehicleCount() const { return m_positionX.size(); }
+    void resize(int count);
+    void clear();
+    
+    void setSeed(quint32 seed) { m_seed = seed; }
+    quint32 seed() const { return m_seed; }
+    void setRoadBounds(const QRectF &bounds);
+    QRectF roadBounds() const { return m_roadBounds; }
+    void setLaneCount(int lanes);
+    int laneCount() const { return m_laneCount; }
+    QSizeF vehicleSize() const { return m_vehicleSize; }
+    
+    const double *positionsX() const { return m_positionX.constData(); }
+    const double *positionsY() const { return m_positionY.constData(); }
+    const double *speeds() const { return m_speed.constData(); }
+    const double *accelerations() const { return m_acceleration.constData(); }
+    const double *maxSpeeds() const { return m_maxSpeed.constData(); }
+    
+    void setSpeed(int index, double speed);
+    void setAcceleration(int index, double acceleration);
+    
+    void setThreadPool(WorkStealingThreadPool *pool);
+    
+    void updatePhysics(double deltaTime, double frictionFactor);
+    void beginSteps(int steps, double deltaTime, double frictionFactor);
+    bool collectSteps();
+    void waitForSteps();
+    bool isStepInFlight() const { return m_stepInFlight; }
+    quint64 positionVersion() const { return m_positionVersion; }
+    bool hasPendingChanges() const { return m_dirty; }
+    void publishChanges();
+    
+    static const int CHUNK_SIZE;
+    
+    double averageSpeed() const { return m_averageSpeed; }
+    double topSpeed() const { return m_topSpeed; }
+
+signals:
+    void fleetResized(int vehicleCount);
+    void fleetUpdated(int vehicleCount, double averageSpeed, double topSpeed);
+
+private:
+    QVector<double> m_positionX;
+    QVector<double> m_positionY;
+    QVector<double> m_speed;
+    QVector<double> m_acceleration;
+    QVector<double> m_maxSpeed;
+    
+    QVector<double> m_backPositionX;
+    QVector<double> m_backSpeed;
+    QVector<FleetKernels::Result> m_chunkResults;
+    
+    WorkStealingThreadPool *m_threadPool;
+    bool m_stepInFlight;
+    bool m_stepFinished;
+    quint64 m_positionVersion;
+    std::mutex m_stepMutex;
+    std::condition_variable m_stepDone;
+    
+    quint32 m_seed;
+    QRectF m_roadBounds;
+    int m_laneCount;
+    QSizeF m_vehicleSize;
+    
+    double m_averageSpeed;
+    double m_topSpeed;
+    bool m_dirty;
+    
+    void spawnVehicles();
+    int chunkCount() const;
+    void finishSteps();
+};
+
+#endif
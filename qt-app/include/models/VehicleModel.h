@@ -7,6 +7,8 @@
 #include <QTimer>
 #include <QPropertyAnimation>
 
+// Setters only record what changed; publishChanges() then emits each
+// notify signal at most once, so a physics step never dispatches signals.
 class VehicleModel : public QObject
 {
     Q_OBJECT
@@ -14,6 +16,11 @@ class VehicleModel : public QObject
     Q_PROPERTY(double speed READ speed WRITE setSpeed NOTIFY speedChanged)
 
 public:
+    enum ChangeFlag : quint32 {
+        PositionChange = 0x01,
+        SpeedChange = 0x02
+    };
+    
     explicit VehicleModel(QObject *parent = nullptr);
     ~VehicleModel();
 
@@ -43,6 +50,9 @@ public:
     
     QPixmap currentSprite() const;
     void loadSprites();
+    
+    quint32 pendingChanges() const { return m_pendingChanges; }
+    void publishChanges();
 
 signals:
     void positionChanged(const QPointF &position);
@@ -64,6 +74,8 @@ private:
     int m_currentFrame;
     QVector<QPixmap> m_sprites;
     bool m_isMoving;
+    bool m_spritesLoaded;
+    quint32 m_pendingChanges;
     
     void initializeVehicle();
     void createSimpleCarSprites();
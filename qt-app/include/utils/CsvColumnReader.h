@@ -0,0 +1,69 @@
+#ifndef CSVCOLUMNREADER_H
+#define CSVCOLUMNREADER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+class WorkStealingThreadPool;
+
+// Reads one numeric column out of a CSV file mapped into memory, so a
+// multi-gigabyte log is parsed in place rather than read into a buffer and
+// split into strings. Fields are split on commas only (no quoting), trimmed
+// of spaces, tabs and CR, and parsed with std::from_chars; rows that are
+// too short or do not parse as a number, such as a header, are skipped.
+//
+// Files that cannot be mapped (empty files, pipes) are read into memory
+// instead. Everything handed out points into the mapping, which stays valid
+// until close() or destruction.
+class CsvColumnReader
+{
+public:
+    // Streams values one at a time without building the column
+    class Cursor
+    {
+    public:
+        bool next(double &value);
+        qint64 rowsRead() const { return m_rows; }
+
+    private:
+        friend class CsvColumnReader;
+        Cursor(const char *begin, const char *end, int columnIndex);
+
+        const char *m_position;
+        const char *m_end;
+        int m_columnIndex;
+        qint64 m_rows;
+    };
+
+    CsvColumnReader();
+    ~CsvColumnReader();
+
+    CsvColumnReader(const CsvColumnReader &) = delete;
+    CsvColumnReader &operator=(const CsvColumnReader &) = delete;
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    qint64 size() const { return m_size; }
+    QString errorString() const { return m_errorString; }
+
+    Cursor cursor(int columnIndex) const;
+    // With a pool, the file is cut into parts on line boundaries and the
+    // parts are parsed in parallel; values keep their file order
+    QVector<double> readColumn(int columnIndex, WorkStealingThreadPool *pool = nullptr) const;
+
+    static bool parseField(const char *first, const char *last, double &value);
+
+    static const qint64 MIN_PARALLEL_PART_SIZE;
+
+private:
+    QFile m_file;
+    QByteArray m_fallback;
+    const char *m_data;
+    qint64 m_size;
+    QString m_errorString;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef DATAPIPELINE_H
+#define DATAPIPELINE_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "StatsKernels.h"
+#include "StreamingFilters.h"
+
+class WorkStealingThreadPool;
+
+// Staged batch processing over chunks of a series: ingest (copy a slice
+// out of the input), validate (drop samples that are not finite or are out
+// of range), filter (the streaming filter chain) and statistics (one-pass
+// moments per chunk, combined at the end).
+//
+// Validation and statistics run on the pool, any number of chunks at once.
+// Filtering keeps state from one chunk to the next, so validated chunks
+// wait in a reorder buffer and whichever worker finds the next one ready
+// filters the run of consecutive chunks. No more than maxChunksInFlight
+// chunks are between ingest and statistics at any time: ingest blocks
+// until one completes, so a fast stage cannot queue the whole input ahead
+// of a slow one.
+class DataPipeline
+{
+public:
+    enum Stage {
+        Ingest,
+        Validate,
+        Filter,
+        Statistics,
+        StageCount
+    };
+
+    // busyNanos is summed over threads; stallNanos is time a stage spent
+    // blocked on a full pipeline
+    struct StageCounters {
+        quint64 chunks;
+        quint64 samples;
+        qint64 busyNanos;
+        qint64 stallNanos;
+    };
+
+    struct Result {
+        QVector<double> filtered;
+        StatsKernels::Moments moments;
+        qint64 rejected;
+        qint64 elapsedNanos;
+    };
+
+    explicit DataPipeline(WorkStealingThreadPool *pool);
+
+    // Not while a run is in progress. The counters are left as they are;
+    // call resetCounters() to start them afresh for the new pool.
+    void setPool(WorkStealingThreadPool *pool);
+    void setChunkSize(int samples);
+    int chunkSize() const { return m_chunkSize; }
+    void setMaxChunksInFlight(int chunks);
+    int maxChunksInFlight() const { return m_maxChunksInFlight; }
+    void setValidRange(double minValue, double maxValue);
+
+    // Blocks until every chunk has been through every stage. The filters
+    // keep their state afterwards, so consecutive runs filter as one series.
+    Result run(const double *data, qint64 count, const std::vector<std::unique_ptr<StreamingFilter>> &filters);
+
+    StageCounters counters(Stage stage) const;
+    void resetCounters();
+
+    static const int DEFAULT_CHUNK_SIZE;
+    static const int DEFAULT_MAX_CHUNKS_IN_FLIGHT;
+
+private:
+    struct AtomicCounters {
+        std::atomic<quint64> chunks;
+        std::atomic<quint64> samples;
+        std::atomic<qint64> busyNanos;
+        std::atomic<qint64> stallNanos;
+    };
+
+    void record(Stage stage, qint64 samples, qint64 nanos);
+
+    WorkStealingThreadPool *m_pool;
+    int m_chunkSize;
+    int m_maxChunksInFlight;
+    double m_validMin;
+    double m_validMax;
+    AtomicCounters m_counters[StageCount];
+};
+
+#endif
@@ -3,11 +3,18 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QVector>
+#include <QPair>
 #include <QDateTime>
 #include <QMutex>
 #include <QThread>
+#include <QTimer>
 #include <memory>
+#include <vector>
+#include "DataPipeline.h"
+#include "QuantileSketch.h"
+#include "StreamingFilters.h"
 
 struct ProcessedData {
     double originalValue;
@@ -33,6 +40,8 @@ struct DataStatistics {
     double totalSquaredSum;
 };
 
+class WorkStealingThreadPool;
+
 struct DataFilter {
     QString name;
     QString type;
@@ -60,6 +69,8 @@ public:
     DataStatistics calculateStatistics(const QVector<double>& data, const QDateTime& start, const QDateTime& end);
     double calculateMean(const QVector<double>& data);
     double calculateMedian(const QVector<double>& data);
+    // Shares one working copy between the percentiles, e.g. {50, 90, 99}
+    QVector<double> calculatePercentiles(const QVector<double>& data, const QVector<double>& percentiles);
     double calculateStandardDeviation(const QVector<double>& data);
     double calculateVariance(const QVector<double>& data);
     double calculateCorrelation(const QVector<double>& data1, const QVector<double>& data2);
@@ -83,6 +94,9 @@ public:
     bool isRealTimeProcessing() const;
     void addRealTimeData(double value, const QDateTime& timestamp = QDateTime::currentDateTime());
     QVector<ProcessedData> getProcessedData() const;
+    // Over every processed value since real-time processing started, not
+    // just the retained ones; approximate (KLL sketch, about 1% in rank)
+    double getRealTimePercentile(double percentile) const;
     
     void addFilter(const DataFilter& filter);
     void removeFilter(const QString& filterName);
@@ -98,6 +112,15 @@ public:
     int getProcessingInterval() const;
     void setAutoProcessing(bool autoProcess);
     bool isAutoProcessing() const;
+    
+    // Runs data through the staged pipeline on a worker pool: validation
+    // against the valid range, the enabled filters (streaming, as in real
+    // time) and statistics. Batches go this way in "parallel" mode.
+    QVector<double> runPipeline(const QVector<double>& data);
+    void setPipelineThreads(int threads);
+    int getPipelineThreads() const;
+    void setValidRange(double minValue, double maxValue);
+    DataPipeline::StageCounters getPipelineCounters(DataPipeline::Stage stage) const;
 
 signals:
     void dataProcessed(const QVector<ProcessedData>& processedData);
@@ -114,28 +137,36 @@ private slots:
 
 private:
     void processBatch(const QVector<double>& data);
-    void applyFilters(QVector<double>& data);
-    void updateStatistics(const QVector<double>& data);
+    void finishBatch(const QVector<double>& filtered, const StatsKernels::Moments& moments);
     
     QVector<double> applyMovingAverageFilter(const QVector<double>& data, int windowSize);
     QVector<double> applyMedianFilter(const QVector<double>& data, int windowSize);
     QVector<double> applyGaussianFilter(const QVector<double>& data, double sigma);
     QVector<double> applyKalmanFilter(const QVector<double>& data, double processNoise, double measurementNoise);
     
-    QVector<double> sortData(const QVector<double>& data);
     double calculatePercentile(const QVector<double>& data, double percentile);
     bool isOutlier(double value, const QVector<double>& data, double threshold);
     QString generateProcessingReport(const QVector<double>& originalData, const QVector<double>& processedData);
     
     void processRealTimeData();
+    // One persistent filter per enabled DataFilter, in order, so real-time
+    // samples are filtered as they arrive instead of with their history
+    void rebuildStreamingFilters();
+    // Shared by the pipeline and parallel CSV import; created on first use
+    WorkStealingThreadPool *pipelinePool();
+    std::vector<std::unique_ptr<StreamingFilter>> createStreamingFilters();
+    std::unique_ptr<StreamingFilter> createStreamingFilter(const DataFilter& filter);
     void addToRealTimeBuffer(double value, const QDateTime& timestamp);
     void flushRealTimeBuffer();
     
     QVector<ProcessedData> m_processedData;
     QVector<DataFilter> m_filters;
+    std::vector<std::unique_ptr<StreamingFilter>> m_streamingFilters;
+    bool m_streamingFiltersDirty;
     QVector<QPair<double, QDateTime>> m_realTimeBuffer;
-    QMutex m_dataMutex;
-    QMutex m_processingMutex;
+    QuantileSketch m_realTimeQuantiles;
+    mutable QMutex m_dataMutex;
+    mutable QMutex m_processingMutex;
     
     QString m_processingMode;
     int m_batchSize;
@@ -153,7 +184,16 @@ private:
     QThread* m_processingThread;
     bool m_isProcessing;
     
+    std::unique_ptr<WorkStealingThreadPool> m_pipelinePool;
+    // Lives as long as the processor, so its counters can be read at any
+    // time without m_processingMutex, even while a run holds it
+    DataPipeline m_pipeline;
+    int m_pipelineThreads;
+    double m_validMin;
+    double m_validMax;
+    
     static const QString DEFAULT_PROCESSING_MODE;
+    static const QString PARALLEL_PROCESSING_MODE;
     static const int DEFAULT_BATCH_SIZE;
     static const int DEFAULT_PROCESSING_INTERVAL;
     static const int REAL_TIME_BUFFER_SIZE;
@@ -0,0 +1,78 @@
+#ifndef LOCALMQTTBROKER_H
+#define LOCALMQTTBROKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QHostAddress>
+#include <QVector>
+#include "MqttFrameDecoder.h"
+#include "MqttPacketEncoder.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+// Minimal MQTT 3.1.1 broker for tests and load generation, so the reporting
+// path can run without a public broker. It understands CONNECT, SUBSCRIBE
+// (with + and # wildcards), PUBLISH at QoS 0 and 1, PINGREQ and DISCONNECT.
+// QoS 1 publishes are acknowledged on receipt; forwarding to subscribers is
+// at most once, so there are no sessions, retained messages or
+// redeliveries. Anything else closes the connection.
+class LocalMqttBroker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LocalMqttBroker(QObject *parent = nullptr);
+    ~LocalMqttBroker();
+
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0);
+    void close();
+    bool isListening() const;
+    quint16 serverPort() const;
+    QString errorString() const;
+
+    int clientCount() const { return int(m_clients.size()); }
+    quint64 publishesReceived() const { return m_publishesReceived; }
+    quint64 bytesReceived() const { return m_bytesReceived; }
+
+    static bool topicMatches(const QByteArray &filter, const QByteArray &topic);
+
+signals:
+    void clientConnected(const QString &clientId);
+    void clientSubscribed(const QString &clientId, const QString &topicFilter);
+    // publish points into the client's receive buffer and is only valid
+    // while the signal is delivered; connect directly, never queued
+    void publishReceived(const MqttPublish &publish);
+
+private:
+    struct Subscription {
+        QByteArray filter;
+        quint8 qos;
+    };
+
+    struct Client {
+        QTcpSocket *socket;
+        MqttFrameDecoder decoder;
+        QByteArray clientId;
+        QVector<Subscription> subscriptions;
+        quint16 packetId;
+        bool connected;
+    };
+
+    QTcpServer *m_server;
+    QHash<QTcpSocket *, Client *> m_clients;
+    MqttPacketEncoder m_encoder;
+    quint64 m_publishesReceived;
+    quint64 m_bytesReceived;
+
+    void acceptClients();
+    void readClient(Client *client);
+    bool handleFrame(Client *client, const MqttFrame &frame);
+    bool handleConnect(Client *client, const MqttFrame &frame);
+    bool handleSubscribe(Client *client, const MqttFrame &frame);
+    bool handlePublish(Client *client, const MqttFrame &frame);
+    void send(Client *client);
+    void dropClient(Client *client, const QString &reason);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef MQTTFRAMEDECODER_H
+#define MQTTFRAMEDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// One complete MQTT control packet. body points at the variable header and
+// payload inside the decoder's buffer; it stays valid until the next call
+// that writes into the decoder.
+struct MqttFrame {
+    enum Type : quint8 {
+        Connect = 1,
+        Connack = 2,
+        Publish = 3,
+        Puback = 4,
+        Pubrec = 5,
+        Pubrel = 6,
+        Pubcomp = 7,
+        Subscribe = 8,
+        Suback = 9,
+        Unsubscribe = 10,
+        Unsuback = 11,
+        Pingreq = 12,
+        Pingresp = 13,
+        Disconnect = 14
+    };
+
+    quint8 header;
+    const char *body;
+    int bodySize;
+
+    Type type() const { return Type(header >> 4); }
+    quint8 flags() const { return header & 0x0F; }
+};
+
+// Topic and payload of a PUBLISH frame, again pointing into the frame body.
+struct MqttPublish {
+    const char *topic;
+    int topicSize;
+    quint8 qos;
+    bool retain;
+    quint16 packetId;
+    const char *payload;
+    int payloadSize;
+};
+
+// Incremental MQTT 3.1.1 frame decoder. Socket reads land directly in the
+// decoder's buffer (prepareWrite/commitWrite) and next() hands out frames in
+// place, so any number of packets per read, and packets split across reads,
+// are reassembled without copying them again.
+//
+// A malformed stream (reserved packet type, remaining length over four bytes
+// or above maxPacketSize) puts the decoder in an error state until reset();
+// MQTT has no way to resynchronise, so the connection should be dropped.
+class MqttFrameDecoder
+{
+public:
+    enum Status {
+        NeedMoreData,
+        FrameReady,
+        Malformed
+    };
+
+    explicit MqttFrameDecoder(int maxPacketSize = DEFAULT_MAX_PACKET_SIZE);
+
+    char *prepareWrite(int size);
+    void commitWrite(int size);
+    void append(const char *data, int size);
+
+    Status next(MqttFrame &frame);
+    void reset();
+
+    int bufferedBytes() const { return m_writePos - m_readPos; }
+    int maxPacketSize() const { return m_maxPacketSize; }
+    quint64 framesDecoded() const { return m_framesDecoded; }
+    QString errorString() const { return m_errorString; }
+
+    static bool decodePublish(const MqttFrame &frame, MqttPublish &publish);
+
+    static const int DEFAULT_MAX_PACKET_SIZE;
+
+private:
+    QByteArray m_buffer;
+    int m_readPos;
+    int m_writePos;
+    int m_maxPacketSize;
+    bool m_malformed;
+    quint64 m_framesDecoded;
+    QString m_errorString;
+
+    Status fail(const QString &error);
+};
+
+#endif
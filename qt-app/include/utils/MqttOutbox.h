@@ -0,0 +1,77 @@
+#ifndef MQTTOUTBOX_H
+#define MQTTOUTBOX_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMap>
+#include <QString>
+
+// QoS 1 messages that the broker has not acknowledged yet, oldest first.
+// With a log file open every enqueue and acknowledgement is appended to it,
+// so unacknowledged messages survive a restart and are loaded again by
+// open(). The log is rewritten with only the pending messages once most of
+// it is acknowledged history.
+//
+// Log layout, all little-endian:
+//
+//   "VSSO" u16 version, then records:
+//     u8 kind, u64 sequence, and for Enqueue
+//       u16 topic length, topic, u32 payload length, payload
+//
+// A record cut short by a crash ends the log; everything before it counts.
+class MqttOutbox
+{
+public:
+    enum RecordKind : quint8 {
+        EnqueueRecord = 1,
+        AckRecord = 2
+    };
+
+    struct Message {
+        quint64 sequence;
+        QByteArray topic;
+        QByteArray payload;
+        int attempts;
+    };
+
+    static const quint32 MAGIC;
+    static const quint16 VERSION;
+    static const int DEFAULT_MAX_MESSAGES;
+
+    explicit MqttOutbox(int maxMessages = DEFAULT_MAX_MESSAGES);
+    ~MqttOutbox();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_errorString; }
+
+    quint64 enqueue(const QByteArray &topic, const QByteArray &payload);
+    bool acknowledge(quint64 sequence);
+    Message *nextAfter(quint64 sequence);
+
+    bool isEmpty() const { return m_pending.isEmpty(); }
+    int pendingCount() const { return int(m_pending.size()); }
+    int maxMessages() const { return m_maxMessages; }
+    quint64 droppedCount() const { return m_droppedCount; }
+
+private:
+    QMap<quint64, Message> m_pending;
+    quint64 m_nextSequence;
+    int m_maxMessages;
+    quint64 m_droppedCount;
+
+    QFile m_file;
+    QByteArray m_record;
+    int m_loggedAcks;
+    QString m_errorString;
+
+    bool load();
+    void maybeCompact();
+    bool compact();
+    void encodeEnqueue(const Message &message);
+    void encodeAck(quint64 sequence);
+    void writeRecord();
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef MQTTPACKETENCODER_H
+#define MQTTPACKETENCODER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Builds MQTT 3.1.1 control packets in one reusable buffer. Each encode call
+// computes the remaining length up front and writes the packet front to
+// back, so once the buffer has grown to the largest packet seen nothing is
+// allocated. The result stays in data()/size() until the next encode call.
+//
+// Strings are taken as UTF-8 bytes; callers keep topics and the client id
+// as QByteArray so nothing is converted per packet.
+class MqttPacketEncoder
+{
+public:
+    explicit MqttPacketEncoder(int initialCapacity = DEFAULT_CAPACITY);
+
+    int encodeConnect(const QByteArray &clientId, quint16 keepAliveSeconds, bool cleanSession = true);
+    int encodeSubscribe(quint16 packetId, const QByteArray &topic, quint8 qos = 0);
+    int encodePublish(const QByteArray &topic, const char *payload, int payloadSize,
+                      quint8 qos = 0, quint16 packetId = 0, bool retain = false, bool dup = false);
+    int encodePublish(const QByteArray &topic, const QByteArray &payload,
+                      quint8 qos = 0, quint16 packetId = 0, bool retain = false, bool dup = false);
+    int encodePingReq();
+
+    // Broker side, for LocalMqttBroker
+    int encodeConnAck(bool sessionPresent, quint8 returnCode);
+    int encodeSubAck(quint16 packetId, const QByteArray &returnCodes);
+    int encodePubAck(quint16 packetId);
+    int encodePingResp();
+
+    const char *data() const { return m_buffer.constData(); }
+    int size() const { return m_size; }
+    int capacity() const { return int(m_buffer.size()); }
+    QByteArray toByteArray() const { return QByteArray(data(), m_size); }
+
+    static int remainingLengthSize(int length);
+
+    static const int DEFAULT_CAPACITY;
+
+private:
+    QByteArray m_buffer;
+    int m_size;
+
+    char *beginPacket(quint8 header, int remainingLength);
+    static char *writeUInt16(char *out, quint16 value);
+    static char *writeString(char *out, const QByteArray &value);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef MQTTWIRETRACE_H
+#define MQTTWIRETRACE_H
+
+#include <QString>
+#include <atomic>
+#include "MqttFrameDecoder.h"
+
+// Compiled in unless the build sets VSS_MQTT_WIRE_TRACE=0, in which case the
+// trace macros below expand to nothing.
+#ifndef VSS_MQTT_WIRE_TRACE
+#define VSS_MQTT_WIRE_TRACE 1
+#endif
+
+// Per-packet tracing for the MQTT client. The level is checked with one
+// relaxed atomic load before any formatting, so with tracing off a packet
+// costs a load and a branch. With a sample interval of N only every Nth
+// packet is traced, which keeps Bytes level usable on a production link.
+//
+// Configured from VSS_MQTT_TRACE=<off|packets|bytes>[:N] at startup, or
+// through setLevel()/setSampleInterval().
+class MqttWireTrace
+{
+public:
+    enum Level {
+        Off = 0,
+        Packets = 1, // Type, direction and size of each packet
+        Bytes = 2    // Packets plus a hex dump of the packet bytes
+    };
+
+    static Level level() { return Level(s_level.load(std::memory_order_relaxed)); }
+    static void setLevel(Level level);
+    static int sampleInterval() { return s_sampleInterval.load(std::memory_order_relaxed); }
+    static void setSampleInterval(int interval);
+    static bool configure(const QString &spec);
+    static void configureFromEnvironment();
+
+    static bool sample();
+    static void tracePacket(const char *direction, const char *packet, int size);
+    static void tracePacket(const char *direction, const MqttFrame &frame);
+
+    static const int MAX_DUMP_BYTES;
+
+private:
+    static std::atomic<int> s_level;
+    static std::atomic<int> s_sampleInterval;
+    static std::atomic<quint32> s_sampleCounter;
+};
+
+#if VSS_MQTT_WIRE_TRACE
+#define MQTT_TRACE_PACKET(direction, ...) \
+    do { \
+        if (MqttWireTrace::level() != MqttWireTrace::Off && MqttWireTrace::sample()) { \
+            MqttWireTrace::tracePacket(direction, __VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define MQTT_TRACE_PACKET(direction, ...) do { } while (0)
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef ORDERSTATISTICS_H
+#define ORDERSTATISTICS_H
+
+#include <QVector>
+
+// Percentiles by selection rather than sorting. A percentile interpolates
+// linearly between the two closest ranks (rank = p / 100 * (n - 1)), the
+// definition DataProcessor has always used. NaN samples are ignored; an
+// empty series gives 0.
+namespace OrderStatistics
+{
+
+// O(n) average: nth_element for the lower rank, the minimum above it for
+// the upper one
+double percentile(QVector<double> data, double percentile);
+
+// All requested percentiles from one working copy. A few queries are
+// answered by selecting each rank within what the previous selection left
+// above it; beyond MAX_SELECTIONS ranks the copy is sorted once instead.
+QVector<double> percentiles(QVector<double> data, const QVector<double> &percentiles);
+
+const int MAX_SELECTIONS = 8;
+
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// KLL quantile sketch for streams too long to keep. Samples go into level
+// 0; a level that reaches its capacity is sorted and every other sample
+// (starting at a random one of the first two) moves up a level with twice
+// the weight. Capacities shrink by 2/3 per level below the top, so about
+// 3k samples are retained however long the stream, and a quantile's rank
+// error is around 1.7 / k of the count (1% at the default k of 200).
+// The exact minimum and maximum are tracked separately.
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(int k = DEFAULT_K);
+
+    void add(double value);
+    // fraction in [0, 1]; 0 for an empty sketch
+    double quantile(double fraction) const;
+    double percentile(double percentile) const { return quantile(percentile / 100.0); }
+    void clear();
+
+    qint64 count() const { return m_count; }
+    int retained() const { return m_retained; }
+    int k() const { return m_k; }
+
+    static const int DEFAULT_K;
+
+private:
+    int capacity(int level) const;
+    void compact();
+    bool nextCoin();
+
+    QVector<QVector<double>> m_levels;
+    int m_k;
+    int m_capacity;
+    int m_retained;
+    qint64 m_count;
+    double m_min;
+    double m_max;
+    quint64 m_randomState;
+};
+
+#endif
@@ -5,23 +5,108 @@
 #include <QTcpSocket>
 #include <QTimer>
 #include <QDateTime>
+#include <QHash>
+#include <atomic>
+#include "../core/SpscRing.h"
+#include "MqttFrameDecoder.h"
+#include "MqttOutbox.h"
+#include "MqttPacketEncoder.h"
+#include "TelemetryBatcher.h"
+#include "TelemetryCodec.h"
+#include "TelemetryThrottle.h"
 
 class SpeedReportingService : public QObject
 {
     Q_OBJECT
 
 public:
+    // Connecting lasts until CONNACK. A dropped or failed connection waits
+    // out a jittered exponential backoff and connects again until
+    // stopReporting().
+    enum ConnectionState {
+        Idle,
+        Connecting,
+        Online,
+        WaitingToReconnect
+    };
+    
+    struct QueueStats {
+        quint64 enqueued;
+        quint64 dropped;
+        quint64 totalNanos;
+        quint64 maxNanos;
+    };
+    
     explicit SpeedReportingService(QObject *parent = nullptr);
     ~SpeedReportingService();
-
+    
+    // The one call meant for another thread. The simulation pushes samples
+    // into a lock-free ring and returns; the service drains it on its own
+    // thread. A full ring drops the sample rather than waiting. Only one
+    // thread may enqueue.
+    bool enqueueSpeed(qint32 vehicleId, double speed, qint64 timestamp);
+    QueueStats queueStats() const;
+    
     void startReporting(const QString &endpoint = "broker.hivemq.com:1883");
     void stopReporting();
     bool isReporting() const;
-    void setSpeedThreshold(double threshold) { m_speedThreshold = threshold; }
+    ConnectionState connectionState() const { return m_connectionState; }
+    int reconnectAttempts() const { return m_reconnectAttempts; }
+    void setReconnectBackoff(int initialDelayMs, int maxDelayMs);
+    
+    // QoS 0 samples reported while offline wait in a bounded ring, oldest
+    // dropped first, and are drained at drainRate() samples per second once
+    // the subscription is back. QoS 1 samples wait in the outbox instead.
+    void setDrainRate(int samplesPerSecond);
+    int drainRate() const { return m_drainRate; }
+    int offlineSampleCount() const { return m_offlineCount; }
+    quint64 offlineDroppedCount() const { return m_offlineDropped; }
+    
+    void setSpeedThreshold(double threshold);
     double speedThreshold() const { return m_speedThreshold; }
+    
+    // Queued samples pass the per-vehicle throttle; crossing the speed
+    // threshold is an alert and skips both the throttle and the batch
+    void setThrottleLimits(double deadband, int minIntervalMs, double maxRate, int burst);
+    const TelemetryThrottle &throttle() const { return m_throttle; }
+    
+    // Batching packs every sample reported within the latency bound, up to
+    // maxSamples, into one PUBLISH on the batch topic
+    void setBatchingEnabled(bool enabled);
+    bool isBatchingEnabled() const { return m_batchingEnabled; }
+    void setBatchLimits(int maxSamples, int maxLatencyMs);
+    const TelemetryBatcher &batcher() const { return m_batcher; }
+    
+    // Binary payloads go to the same topics with TelemetryCodec's suffix
+    void setPayloadFormat(TelemetryCodec::Format format);
+    TelemetryCodec::Format payloadFormat() const { return m_payloadFormat; }
+    
+    // At QoS 1 telemetry goes through the outbox and stays there until the
+    // broker's PUBACK. Up to the in-flight window is sent before the first
+    // acknowledgement comes back, and everything unacknowledged is sent
+    // again after a reconnect. With an outbox file that includes restarts.
+    void setQos(int qos);
+    int qos() const { return m_qos; }
+    void setInFlightWindow(int messages);
+    int inFlightWindow() const { return m_inFlightWindow; }
+    bool setOutboxPath(const QString &path);
+    const MqttOutbox &outbox() const { return m_outbox; }
+    
+    static const int DEFAULT_IN_FLIGHT_WINDOW;
+    static const int DEFAULT_RECONNECT_DELAY_MS;
+    static const int DEFAULT_MAX_RECONNECT_DELAY_MS;
+    static const int OFFLINE_BUFFER_SIZE;
+    static const int DEFAULT_DRAIN_RATE;
+    static const int REPORT_QUEUE_SIZE;
+    
+    QByteArray formatSpeedMessage(double speed) const;
+    QByteArray formatSpeedMessage(const SpeedSample &sample) const;
+    QByteArray formatBatchMessage(const SpeedSample *samples, int count) const;
 
 public slots:
     void onSpeedChanged(double speed);
+    void reportSpeed(qint32 vehicleId, double speed, qint64 timestamp);
+    void flushBatch();
 
 signals:
     void reportingStatusChanged(bool reporting);
@@ -34,22 +119,85 @@ private:
     QTcpSocket *m_socket;
     QTimer *m_reportingTimer;
     double m_speedThreshold;
-    double m_lastSentSpeed;
+    TelemetryThrottle m_throttle;
     QString m_endpoint;
+    QString m_host;
+    quint16 m_port;
     bool m_isReporting;
     bool m_isSubscribed;
     QString m_clientId;
     int m_packetId;
-
-    QByteArray encodeRemainingLength(int length);
+    MqttFrameDecoder m_decoder;
+    
+    // Encoded once; every packet is built in m_encoder's reused buffer
+    QByteArray m_clientIdBytes;
+    QByteArray m_publishTopic;
+    QByteArray m_alertTopic;
+    QByteArray m_batchTopic;
+    QByteArray m_binaryPublishTopic;
+    QByteArray m_binaryBatchTopic;
+    MqttPacketEncoder m_encoder;
+    
+    TelemetryCodec::Format m_payloadFormat;
+    QByteArray m_binaryPayload;
+    bool m_batchingEnabled;
+    TelemetryBatcher m_batcher;
+    QTimer *m_batchTimer;
+    
+    int m_qos;
+    int m_inFlightWindow;
+    MqttOutbox m_outbox;
+    QHash<quint16, quint64> m_inFlight; // packet id -> outbox sequence
+    quint64 m_lastSentSequence;
+    
+    ConnectionState m_connectionState;
+    QTimer *m_reconnectTimer;
+    int m_reconnectAttempts;
+    int m_reconnectDelay;
+    int m_maxReconnectDelay;
+    
+    SpscRing<SpeedSample> m_reportQueue;
+    std::atomic<bool> m_drainScheduled;
+    std::atomic<quint64> m_enqueued;
+    std::atomic<quint64> m_enqueueDropped;
+    std::atomic<quint64> m_enqueueNanos;
+    std::atomic<quint64> m_enqueueMaxNanos;
+    
+    SpscRing<SpeedSample> m_offlineSamples;
+    int m_offlineCount;
+    quint64 m_offlineDropped;
+    QTimer *m_drainTimer;
+    int m_drainRate;
+    // Thousandths of a sample carried from one drain tick to the next, so
+    // rates below one sample per tick still come out right
+    qint64 m_drainCredit;
+    
     void setupReportingTimer();
-    void sendSpeedData(double speed);
-    QString formatSpeedMessage(double speed);
+    void drainReportQueue();
+    void considerSpeed(const SpeedSample &sample);
+    void publishAlert(const SpeedSample &sample);
+    void connectToBroker();
+    void scheduleReconnect();
+    bool isOnline() const;
+    void submitSample(const SpeedSample &sample);
+    void bufferOffline(const SpeedSample &sample);
+    void drainOffline();
+    void clearOffline();
+    void sendSpeedData(const SpeedSample &sample);
+    void publishSamples(const QByteArray &jsonTopic, const QByteArray &binaryTopic,
+                        const SpeedSample *samples, int count);
+    void publishTelemetry(const QByteArray &topic, const QByteArray &payload);
+    void pumpOutbox();
+    quint16 nextPacketId();
+    QString vehicleName(qint32 vehicleId) const;
     void sendMqttConnect();
-    void sendMqttPublish(const QString &topic, const QString &message);
-    void sendMqttSubscribe(const QString &topic);
+    void sendMqttPublish(const QByteArray &topic, const QByteArray &message);
+    void sendMqttSubscribe(const QByteArray &topic);
     void sendMqttPingReq();
-    void handleMqttMessage(const QByteArray &packet);
+    void readMqttFrames();
+    void handleMqttFrame(const MqttFrame &frame);
+    void handlePubAck(const MqttFrame &frame);
+    void handleMqttMessage(const MqttPublish &publish);
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef STATSKERNELS_H
+#define STATSKERNELS_H
+
+#include <QtGlobal>
+
+// Single-pass reductions behind DataProcessor's statistics. Sums are taken
+// of the samples minus a shift (the first sample), which keeps the sum of
+// squares from cancelling when the spread is small next to the mean, and
+// every sum is Kahan-compensated. The AVX2 path accumulates in eight lanes,
+// so its sums may differ from the scalar path's in the last bits; minimum
+// and maximum are exact on both.
+namespace StatsKernels
+{
+
+enum class Path {
+    Scalar,
+    Avx2
+};
+
+struct Moments {
+    qint64 count;
+    double shift;
+    double sum;         // of (x - shift)
+    double sumSquares;  // of (x - shift)^2
+    double minValue;
+    double maxValue;
+};
+
+struct CrossMoments {
+    qint64 count;
+    double shiftX;
+    double shiftY;
+    double sumX;
+    double sumY;
+    double sumXX;
+    double sumYY;
+    double sumXY;
+};
+
+bool isPathSupported(Path path);
+Path bestSupportedPath();
+Path activePath();
+void setActivePath(Path path);
+const char *pathName(Path path);
+
+Moments moments(const double *data, qint64 count);
+Moments moments(Path path, const double *data, qint64 count);
+CrossMoments crossMoments(const double *x, const double *y, qint64 count);
+CrossMoments crossMoments(Path path, const double *x, const double *y, qint64 count);
+
+// Moments of the two series end to end, expressed around a's shift, so
+// chunks summed separately can be put back together
+Moments combine(const Moments &a, const Moments &b);
+
+double mean(const Moments &moments);
+// Sample variance (n - 1), 0 for fewer than two samples
+double variance(const Moments &moments);
+double rawSum(const Moments &moments);
+double rawSumSquares(const Moments &moments);
+// Pearson correlation, 0 when either side is constant
+double correlation(const CrossMoments &moments);
+
+}
+
+#endif
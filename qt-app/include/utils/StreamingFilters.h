@@ -0,0 +1,99 @@
+#ifndef STREAMINGFILTERS_H
+#define STREAMINGFILTERS_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <set>
+
+// Filters that take one sample at a time and keep their state between
+// calls, for real-time data that should not be refiltered from the start of
+// its history on every new sample. All of them are causal: the output for
+// a sample depends only on that sample and the ones before it, which is
+// what the last element of the matching DataProcessor batch filter sees.
+//
+// Non-finite samples are returned unchanged and do not enter the state, so
+// one bad reading cannot poison a running sum or the median's ordering.
+class StreamingFilter
+{
+public:
+    virtual ~StreamingFilter() {}
+
+    virtual double push(double value) = 0;
+    virtual void reset() = 0;
+};
+
+// Trailing mean over up to windowSize samples, O(1) per sample. The running
+// sum is recomputed every time the window wraps so rounding cannot drift.
+class StreamingMovingAverage : public StreamingFilter
+{
+public:
+    explicit StreamingMovingAverage(int windowSize);
+
+    double push(double value) override;
+    void reset() override;
+
+private:
+    QVector<double> m_window;
+    int m_next;
+    int m_count;
+    double m_sum;
+};
+
+// Trailing median over up to windowSize samples, O(log windowSize) per
+// sample. The two halves are ordered trees rather than heaps so the sample
+// leaving the window can be removed directly.
+class StreamingMedian : public StreamingFilter
+{
+public:
+    explicit StreamingMedian(int windowSize);
+
+    double push(double value) override;
+    void reset() override;
+
+private:
+    QVector<double> m_window;
+    int m_next;
+    int m_count;
+    std::multiset<double> m_lower;
+    std::multiset<double> m_upper;
+
+    void rebalance();
+};
+
+// The trailing half of a Gaussian kernel truncated at three sigma,
+// renormalised over the samples seen so far. O(sigma) per sample with the
+// weights computed once.
+class StreamingGaussian : public StreamingFilter
+{
+public:
+    explicit StreamingGaussian(double sigma);
+
+    double push(double value) override;
+    void reset() override;
+
+private:
+    QVector<double> m_weights;
+    QVector<double> m_history;
+    int m_next;
+    int m_count;
+};
+
+// One-dimensional constant-value Kalman filter; the estimate and its error
+// covariance carry over from one sample to the next.
+class StreamingKalman : public StreamingFilter
+{
+public:
+    StreamingKalman(double processNoise, double measurementNoise);
+
+    double push(double value) override;
+    void reset() override;
+
+private:
+    double m_processNoise;
+    double m_measurementNoise;
+    double m_estimate;
+    double m_errorCovariance;
+    bool m_initialized;
+};
+
+#endif
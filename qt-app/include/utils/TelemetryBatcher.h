@@ -0,0 +1,49 @@
+#ifndef TELEMETRYBATCHER_H
+#define TELEMETRYBATCHER_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// One speed reading from one vehicle. Fleet vehicles use their FleetModel
+// index, the player's vehicle is PLAYER_VEHICLE.
+struct SpeedSample {
+    enum : qint32 {
+        PLAYER_VEHICLE = -1
+    };
+
+    qint32 vehicleId;
+    qint64 timestamp; // Milliseconds since the Unix epoch
+    double speed;     // km/h
+};
+
+// Collects speed samples that go out together in one PUBLISH. A batch is due
+// once it holds maxSamples samples, which add() reports, or maxLatency after
+// its first sample went in, which the owner times.
+class TelemetryBatcher
+{
+public:
+    explicit TelemetryBatcher(int maxSamples = DEFAULT_MAX_SAMPLES, int maxLatencyMs = DEFAULT_MAX_LATENCY_MS);
+
+    void setMaxSamples(int maxSamples);
+    int maxSamples() const { return m_maxSamples; }
+    void setMaxLatency(int milliseconds);
+    int maxLatency() const { return m_maxLatencyMs; }
+
+    bool add(const SpeedSample &sample);
+    bool isEmpty() const { return m_samples.isEmpty(); }
+    bool isFull() const { return m_samples.size() >= m_maxSamples; }
+    int size() const { return int(m_samples.size()); }
+
+    const QVector<SpeedSample> &samples() const { return m_samples; }
+    void clear();
+
+    static const int DEFAULT_MAX_SAMPLES;
+    static const int DEFAULT_MAX_LATENCY_MS;
+
+private:
+    QVector<SpeedSample> m_samples;
+    int m_maxSamples;
+    int m_maxLatencyMs;
+};
+
+#endif
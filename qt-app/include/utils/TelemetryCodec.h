@@ -0,0 +1,48 @@
+#ifndef TELEMETRYCODEC_H
+#define TELEMETRYCODEC_H
+
+#include <QByteArray>
+#include <QVector>
+#include "TelemetryBatcher.h"
+
+// Binary speed telemetry, the compact alternative to the JSON messages.
+// Subscribers pick a format by topic: binary payloads are published on the
+// JSON topic plus BINARY_TOPIC_SUFFIX ("/bin/v1"), so consumers that only
+// understand JSON never receive them. A new layout gets a new version and a
+// new suffix.
+//
+// Layout version 1, all fields little-endian:
+//
+//   Header, 12 bytes
+//     0  u8   version           1
+//     1  u8   flags             0, reserved
+//     2  u16  sample count      N
+//     4  i64  base timestamp    epoch milliseconds of the first sample
+//
+//   N records of 12 bytes, starting at offset 12
+//     0  i32  vehicle id        -1 for the player's vehicle, else fleet index
+//     4  i32  timestamp delta   milliseconds relative to the base timestamp
+//     8  f32  speed             km/h
+//
+// A payload is exactly 12 + 12 * N bytes; decoders reject anything else.
+namespace TelemetryCodec {
+
+enum class Format {
+    Json,
+    Binary
+};
+
+const quint8 BINARY_VERSION = 1;
+const int HEADER_SIZE = 12;
+const int RECORD_SIZE = 12;
+const int MAX_SAMPLES = 65535;
+extern const char BINARY_TOPIC_SUFFIX[];
+
+QByteArray topicFor(const QByteArray &jsonTopic, Format format);
+
+int encodeBinary(const SpeedSample *samples, int count, QByteArray &out);
+bool decodeBinary(const char *data, int size, QVector<SpeedSample> &samples);
+
+}
+
+#endif
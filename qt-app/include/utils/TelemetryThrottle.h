@@ -0,0 +1,76 @@
+#ifndef TELEMETRYTHROTTLE_H
+#define TELEMETRYTHROTTLE_H
+
+#include <QVector>
+#include <QtGlobal>
+#include "TelemetryBatcher.h"
+
+// Decides per vehicle which speed samples are worth publishing. A sample is
+// suppressed when it is within the deadband of the last one published, when
+// the vehicle published less than minInterval ago, or when the vehicle's
+// token bucket (maxRate per second, up to burst saved up) is empty.
+//
+// Crossing the alert threshold from below is an alert and always goes out,
+// without spending a token. Time comes from the sample timestamps, so
+// replayed or delayed samples are judged by when they were taken.
+class TelemetryThrottle
+{
+public:
+    enum Verdict {
+        Suppressed,
+        Admitted,
+        Alert
+    };
+
+    explicit TelemetryThrottle(double deadband = DEFAULT_DEADBAND, int minIntervalMs = 0,
+                               double maxRate = 0.0, int burst = 1);
+
+    void setDeadband(double kmh);
+    double deadband() const { return m_deadband; }
+    void setMinInterval(int milliseconds);
+    int minInterval() const { return m_minIntervalMs; }
+    // maxRate 0 means unlimited
+    void setMaxRate(double perSecond, int burst);
+    double maxRate() const { return m_maxRate; }
+    int burst() const { return m_burst; }
+    void setAlertThreshold(double kmh) { m_alertThreshold = kmh; }
+    double alertThreshold() const { return m_alertThreshold; }
+
+    Verdict admit(const SpeedSample &sample);
+    // Tracks a sample that is not up for publishing, so the next one above
+    // the threshold still counts as a crossing
+    void observe(const SpeedSample &sample);
+    void clear();
+
+    int trackedVehicles() const { return int(m_vehicles.size()); }
+    quint64 suppressedCount() const { return m_suppressed; }
+    quint64 alertCount() const { return m_alerts; }
+
+    static const double DEFAULT_DEADBAND;
+    static const int MAX_TRACKED_VEHICLES;
+
+private:
+    struct VehicleState {
+        double lastSpeed;
+        qint64 lastPublished;
+        qint64 lastRefill;
+        double tokens;
+        bool published;
+        bool aboveThreshold;
+    };
+
+    // Indexed by vehicle id + 1: fleet ids are dense indices and the
+    // player's vehicle is -1
+    QVector<VehicleState> m_vehicles;
+    double m_deadband;
+    int m_minIntervalMs;
+    double m_maxRate;
+    int m_burst;
+    double m_alertThreshold;
+    quint64 m_suppressed;
+    quint64 m_alerts;
+
+    VehicleState *stateFor(qint32 vehicleId);
+};
+
+#endif
@@ -58,6 +58,7 @@ public slots:
 private:
    
     GameEngine *m_gameEngine;
+    GameEngine::SnapshotCursor m_snapshotCursor;
     GameView *m_gameView;
     
     
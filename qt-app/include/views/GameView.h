@@ -30,9 +30,9 @@ protected:
 private slots:
     void onGameEngineChanged();
     void animateCar();
-    void updateCarPosition();
 
 private:
+    void updateCarPosition(const FrameSnapshot &snapshot);
     void setupScene();
     void loadRoadBackground();
     void createCarSprite();
@@ -41,6 +41,7 @@ private:
     void createWoodenBorder(int roadWidth, int roadHeight);
 
     GameEngine *m_gameEngine;
+    GameEngine::SnapshotCursor m_snapshotCursor;
     QGraphicsScene *m_scene;
     QGraphicsPixmapItem *m_roadBackground;
     QGraphicsPixmapItem *m_carSprite;
@@ -13,6 +13,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QApplication>
+#include <QThread>
 #include "GameView.h"
 #include "ControlPanel.h"
 #include "../core/GameEngine.h"
@@ -46,6 +47,7 @@ private:
     
     
     GameEngine *m_gameEngine;
+    QThread *m_engineThread;
     
     
     QAction *m_startAction;
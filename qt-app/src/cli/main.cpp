@@ -0,0 +1,258 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "core/GameEngine.h"
+#include "core/FleetKernels.h"
+#include "core/SessionRecorder.h"
+#include "core/SessionPlayer.h"
+#include "utils/MqttWireTrace.h"
+
+// Runs GameEngine physics without a GUI, as fast as the host allows.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    app.setApplicationName("VehicleSimCli");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("VehicleSpeedCheckout");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless vehicle speed simulation runner");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    
+    QCommandLineOption durationOption("duration", "Simulated time to run, in seconds.", "seconds", "60");
+    QCommandLineOption rateOption("physics-rate", "Fixed physics rate in Hz.", "hz", "240");
+    QCommandLineOption frameRateOption("frame-rate", "Simulated frame rate driving the engine, in Hz.", "hz", "60");
+    QCommandLineOption speedOption("speed", "Initial vehicle speed in km/h.", "kmh", "100");
+    QCommandLineOption fleetOption("fleet", "Number of additional fleet vehicles to simulate.", "count", "0");
+    QCommandLineOption threadsOption("threads", "Worker threads for fleet physics (0 runs it on the main thread).", "count");
+    QCommandLineOption kernelOption("kernel", "Fleet kernel path: scalar, sse4.1 or avx2 (default: best supported).", "path");
+    QCommandLineOption roadOption("road-length", "Length of the looping road in pixels (default: two vehicle lengths per fleet slot).", "pixels");
+    QCommandLineOption recordOption("record", "Record the session to a binary log.", "file");
+    QCommandLineOption replayOption("replay", "Replay a recorded session log and verify it tick by tick.", "file");
+    QCommandLineOption reportOption("report", "Publish speed reports to an MQTT broker.", "endpoint");
+    QCommandLineOption batchOption("report-batch", "Batch speed reports: up to this many samples per message, optionally samples:milliseconds.", "samples");
+    QCommandLineOption formatOption("report-format", "Speed report payload: json or binary.", "format", "json");
+    QCommandLineOption qosOption("report-qos", "Speed report QoS: 0, or 1 to resend until the broker acknowledges.", "qos", "0");
+    QCommandLineOption outboxOption("outbox", "Keep unacknowledged QoS 1 reports in this file across restarts.", "file");
+    QCommandLineOption throttleOption("report-throttle", "Per-vehicle report throttle: deadband km/h, optionally deadband:interval_ms:rate:burst.", "limits");
+    QCommandLineOption traceOption("mqtt-trace", "Trace MQTT packets: off, packets or bytes, optionally sampled as level:N.", "level");
+    parser.addOption(durationOption);
+    parser.addOption(rateOption);
+    parser.addOption(frameRateOption);
+    parser.addOption(speedOption);
+    parser.addOption(fleetOption);
+    parser.addOption(kernelOption);
+    parser.addOption(threadsOption);
+    parser.addOption(roadOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(reportOption);
+    parser.addOption(batchOption);
+    parser.addOption(formatOption);
+    parser.addOption(qosOption);
+    parser.addOption(outboxOption);
+    parser.addOption(throttleOption);
+    parser.addOption(traceOption);
+    parser.process(app);
+    
+    double duration = parser.value(durationOption).toDouble();
+    int physicsRate = parser.value(rateOption).toInt();
+    int frameRate = qMax(1, parser.value(frameRateOption).toInt());
+    double initialSpeed = parser.value(speedOption).toDouble();
+    int fleetSize = parser.value(fleetOption).toInt();
+    bool reporting = parser.isSet(reportOption);
+    
+    if (parser.isSet(kernelOption)) {
+        QString kernel = parser.value(kernelOption);
+        if (kernel == "scalar") {
+            FleetKernels::setActivePath(FleetKernels::Path::Scalar);
+        } else if (kernel == "sse4.1") {
+            FleetKernels::setActivePath(FleetKernels::Path::Sse41);
+        } else if (kernel == "avx2") {
+            FleetKernels::setActivePath(FleetKernels::Path::Avx2);
+        } else {
+            QTextStream(stderr) << "Invalid --kernel value: " << kernel << " (expected scalar, sse4.1 or avx2)\n";
+            return 1;
+        }
+    }
+    
+    GameEngine engine;
+    QTextStream out(stdout);
+    
+    if (parser.isSet(replayOption)) {
+        SessionPlayer player;
+        if (!player.open(parser.value(replayOption))) {
+            QTextStream(stderr) << "Cannot replay " << parser.value(replayOption) << ": " << player.errorString() << "\n";
+            return 1;
+        }
+        if (parser.isSet(threadsOption)) {
+            engine.setWorkerThreadCount(parser.value(threadsOption).toInt());
+        }
+        player.configure(engine);
+        
+        QElapsedTimer wallClock;
+        wallClock.start();
+        bool complete = player.replay(engine);
+        double wallSeconds = wallClock.nsecsElapsed() / 1e9;
+        
+        out << "Replayed ticks:   " << player.ticksReplayed() << " @ " << engine.physicsRate() << " Hz\n";
+        out << "Replayed inputs:  " << player.inputsReplayed() << "\n";
+        out << "Simulated time:   " << engine.simulationTime() << " s\n";
+        out << "Wall time:        " << wallSeconds << " s\n";
+        out << "Real-time factor: " << (wallSeconds > 0.0 ? engine.simulationTime() / wallSeconds : 0.0) << "x\n";
+        out << "Divergent ticks:  " << player.divergentTicks();
+        if (player.divergentTicks() > 0) {
+            out << " (first at tick " << player.firstDivergentTick() << ")";
+        }
+        out << "\n";
+        if (!complete) {
+            out << "Warning:          " << player.errorString() << "\n";
+        }
+        engine.stopGame();
+        
+        return complete && player.divergentTicks() == 0 ? 0 : 1;
+    }
+    
+    engine.setExternalClockEnabled(true);
+    engine.setPhysicsRate(physicsRate);
+    if (parser.isSet(threadsOption)) {
+        engine.setWorkerThreadCount(parser.value(threadsOption).toInt());
+    }
+    engine.setFleetSize(fleetSize);
+    engine.setFleetReportingEnabled(reporting);
+    
+    // Keep fleet density, and with it the collision count, independent of size
+    QRectF road = engine.roadBounds();
+    if (parser.isSet(roadOption)) {
+        road.setWidth(parser.value(roadOption).toDouble());
+    } else {
+        int perLane = (fleetSize + engine.fleet()->laneCount() - 1) / engine.fleet()->laneCount();
+        road.setWidth(qMax(road.width(), perLane * engine.fleet()->vehicleSize().width() * 2));
+    }
+    engine.setRoadBounds(road);
+    
+    quint64 collisionPairs = 0;
+    quint64 offRoadEvents = 0;
+    QObject::connect(&engine, &GameEngine::collisionsDetected, [&](const QVector<QPair<int, int>> &pairs) {
+        collisionPairs += pairs.size();
+    });
+    QObject::connect(&engine, &GameEngine::vehiclesOffRoad, [&](const QVector<int> &vehicles) {
+        offRoadEvents += vehicles.size();
+    });
+    
+    // A simulated frame must never exceed the catch-up budget or time is dropped
+    engine.setMaxCatchUpSteps(engine.physicsRate() / frameRate + 1);
+    
+    if (parser.isSet(traceOption) && !MqttWireTrace::configure(parser.value(traceOption))) {
+        QTextStream(stderr) << "Invalid --mqtt-trace value: " << parser.value(traceOption) << "\n";
+        return 1;
+    }
+    
+    QString reportFormat = parser.value(formatOption);
+    if (reportFormat != "json" && reportFormat != "binary") {
+        QTextStream(stderr) << "Invalid --report-format value: " << reportFormat << "\n";
+        return 1;
+    }
+    
+    QString reportQos = parser.value(qosOption);
+    if (reportQos != "0" && reportQos != "1") {
+        QTextStream(stderr) << "Invalid --report-qos value: " << reportQos << "\n";
+        return 1;
+    }
+    
+    // The service runs on the engine's reporting thread, so it is set up there
+    SpeedReportingService *service = engine.speedReportingService();
+    QString reportError;
+    QMetaObject::invokeMethod(service, [&]() {
+        if (reportFormat == "binary") {
+            service->setPayloadFormat(TelemetryCodec::Format::Binary);
+        }
+        service->setQos(reportQos.toInt());
+        
+        if (parser.isSet(outboxOption) && !service->setOutboxPath(parser.value(outboxOption))) {
+            reportError = QString("Cannot open outbox %1: %2").arg(parser.value(outboxOption), service->outbox().errorString());
+            return;
+        }
+        
+        if (parser.isSet(throttleOption)) {
+            QStringList limits = parser.value(throttleOption).split(':');
+            service->setThrottleLimits(limits.value(0).toDouble(), limits.value(1).toInt(),
+                                       limits.value(2).toDouble(), qMax(1, limits.value(3).toInt()));
+        }
+        
+        if (parser.isSet(batchOption)) {
+            QStringList limits = parser.value(batchOption).split(':');
+            service->setBatchLimits(limits.value(0).toInt(),
+                                    limits.size() > 1 ? limits[1].toInt() : service->batcher().maxLatency());
+            service->setBatchingEnabled(true);
+        }
+        
+        if (reporting) {
+            service->startReporting(parser.value(reportOption));
+        }
+    }, Qt::BlockingQueuedConnection);
+    
+    if (!reportError.isEmpty()) {
+        QTextStream(stderr) << reportError << "\n";
+        return 1;
+    }
+    
+    SessionRecorder recorder;
+    if (parser.isSet(recordOption)) {
+        if (!recorder.open(parser.value(recordOption))) {
+            QTextStream(stderr) << "Cannot record to " << parser.value(recordOption) << ": " << recorder.errorString() << "\n";
+            return 1;
+        }
+        engine.setSessionRecorder(&recorder);
+    }
+    
+    engine.startGame();
+    engine.requestVehicleSpeed(initialSpeed);
+    
+    double frameTime = 1.0 / frameRate;
+    QElapsedTimer wallClock;
+    wallClock.start();
+    
+    while (engine.simulationTime() < duration) {
+        engine.advanceFrame(frameTime);
+    }
+    
+    double wallSeconds = wallClock.nsecsElapsed() / 1e9;
+    double finalSpeed = engine.vehicle()->speed();
+    engine.stopGame();
+    recorder.close();
+    
+    out << "Simulated time:   " << engine.simulationTime() << " s\n";
+    out << "Physics steps:    " << engine.simulationTick() << " @ " << engine.physicsRate() << " Hz\n";
+    out << "Wall time:        " << wallSeconds << " s\n";
+    out << "Real-time factor: " << (wallSeconds > 0.0 ? engine.simulationTime() / wallSeconds : 0.0) << "x\n";
+    out << "Final speed:      " << finalSpeed << " km/h\n";
+    out << "Final position:   " << engine.vehicle()->position().x() << ", " << engine.vehicle()->position().y() << "\n";
+    if (parser.isSet(recordOption)) {
+        out << "Session log:      " << recorder.bytesWritten() << " bytes\n";
+    }
+    
+    if (reporting) {
+        SpeedReportingService::QueueStats stats = service->queueStats();
+        out << "Report enqueues:  " << stats.enqueued << ", " << stats.dropped << " dropped, "
+            << (stats.enqueued > 0 ? stats.totalNanos / stats.enqueued : 0) << " ns mean, "
+            << stats.maxNanos << " ns max\n";
+    }
+    
+    if (fleetSize > 0) {
+        double vehicleSteps = double(engine.simulationTick()) * engine.fleet()->vehicleCount();
+        out << "Fleet vehicles:   " << engine.fleet()->vehicleCount() << "\n";
+        out << "Fleet kernel:     " << FleetKernels::pathName(FleetKernels::activePath()) << "\n";
+        out << "Worker threads:   " << engine.workerThreadCount() << "\n";
+        out << "Fleet avg speed:  " << engine.fleet()->averageSpeed() << " km/h\n";
+        out << "Vehicle updates:  " << (wallSeconds > 0.0 ? vehicleSteps / wallSeconds : 0.0) << " /s\n";
+        out << "Road length:      " << engine.roadBounds().width() << " px\n";
+        out << "Collision pairs:  " << collisionPairs << "\n";
+        out << "Off-road events:  " << offRoadEvents << "\n";
+    }
+    
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "core/CollisionDetector.h"
+#include "core/WorkStealingThreadPool.h"
+#include "models/FleetModel.h"
+#include <cmath>
+
+const int CollisionDetector::PLAYER_VEHICLE = -1;
+
+CollisionDetector::CollisionDetector()
+    : m_threadPool(nullptr)
+    , m_roadBounds(0, 250, 2000, 100)
+{
+}
+
+void CollisionDetector::forChunks(int count, const std::function<void(int)> &body)
+{
+    int chunks = (count + FleetModel::CHUNK_SIZE - 1) / FleetModel::CHUNK_SIZE;
+    if (m_threadPool) {
+        m_threadPool->parallelFor(chunks, body);
+    } else {
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            body(chunk);
+        }
+    }
+}
+
+void CollisionDetector::updateFleet(const FleetModel &fleet)
+{
+    QSizeF size = fleet.vehicleSize();
+    m_grid.setCellSize(qMax(size.width(), size.height()));
+    
+    int count = fleet.vehicleCount();
+    m_cellKeys.resize(count);
+    
+    // Keys are computed in parallel; only the vehicles that changed cell
+    // touch the hash, which has to happen on this thread.
+    const double *x = fleet.positionsX();
+    const double *y = fleet.positionsY();
+    quint64 *keys = m_cellKeys.data();
+    const SpatialGrid &grid = m_grid;
+    forChunks(count, [=, &grid](int chunk) {
+        int first = chunk * FleetModel::CHUNK_SIZE;
+        int last = qMin(first + FleetModel::CHUNK_SIZE, count);
+        for (int i = first; i < last; ++i) {
+            keys[i] = grid.cellKey(x[i], y[i]);
+        }
+    });
+    
+    m_grid.update(keys, count);
+}
+
+void CollisionDetector::detectFleet(const FleetModel &fleet, CollisionReport &report)
+{
+    updateFleet(fleet);
+    
+    int count = fleet.vehicleCount();
+    int chunks = (count + FleetModel::CHUNK_SIZE - 1) / FleetModel::CHUNK_SIZE;
+    m_chunkPairs.resize(chunks);
+    m_chunkOffRoad.resize(chunks);
+    
+    const double *x = fleet.positionsX();
+    const double *y = fleet.positionsY();
+    const quint64 *keys = m_cellKeys.constData();
+    double width = fleet.vehicleSize().width();
+    double height = fleet.vehicleSize().height();
+    double roadTop = m_roadBounds.top();
+    double roadBottom = m_roadBounds.bottom();
+    QVector<QPair<int, int>> *chunkPairs = m_chunkPairs.data();
+    QVector<int> *chunkOffRoad = m_chunkOffRoad.data();
+    const SpatialGrid &grid = m_grid;
+    
+    // Half stencil: a vehicle's own cell (later items only) plus the four
+    // cells ahead of it, so every pair is found exactly once. The fleet
+    // track wraps along x, so only the lateral edges of the road can be left.
+    static const int forwardCells[4][2] = { { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    
+    forChunks(count, [=, &grid](int chunk) {
+        int first = chunk * FleetModel::CHUNK_SIZE;
+        int last = qMin(first + FleetModel::CHUNK_SIZE, count);
+        QVector<QPair<int, int>> &pairs = chunkPairs[chunk];
+        QVector<int> &offRoad = chunkOffRoad[chunk];
+        pairs.clear();
+        offRoad.clear();
+        
+        auto testPair = [&](int i, int j) {
+            if (std::abs(x[i] - x[j]) < width && std::abs(y[i] - y[j]) < height) {
+                pairs.append(qMakePair(qMin(i, j), qMax(i, j)));
+            }
+        };
+        
+        for (int i = first; i < last; ++i) {
+            if (y[i] - height / 2 < roadTop || y[i] + height / 2 > roadBottom) {
+                offRoad.append(i);
+            }
+            
+            const QVector<int> *own = grid.itemsInCell(keys[i]);
+            for (int j : *own) {
+                if (j > i) {
+                    testPair(i, j);
+                }
+            }
+            
+            qint32 cellX = SpatialGrid::keyCellX(keys[i]);
+            qint32 cellY = SpatialGrid::keyCellY(keys[i]);
+            for (const int *offset : forwardCells) {
+                const QVector<int> *cell = grid.itemsInCell(SpatialGrid::packKey(cellX + offset[0], cellY + offset[1]));
+                if (cell) {
+                    for (int j : *cell) {
+                        testPair(i, j);
+                    }
+                }
+            }
+        }
+    });
+    
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        report.vehiclePairs += m_chunkPairs[chunk];
+        report.offRoadVehicles += m_chunkOffRoad[chunk];
+    }
+}
+
+void CollisionDetector::detectPlayer(const FleetModel &fleet, const QRectF &playerBounds, CollisionReport &report) const
+{
+    if (m_grid.itemCount() != fleet.vehicleCount()) {
+        return;
+    }
+    
+    // The player may be larger than a cell, so walk every cell its bounds
+    // can reach once grown by half a fleet vehicle on each side.
+    const double *x = fleet.positionsX();
+    const double *y = fleet.positionsY();
+    QSizeF size = fleet.vehicleSize();
+    QRectF reach = playerBounds.adjusted(-size.width() / 2, -size.height() / 2,
+                                         size.width() / 2, size.height() / 2);
+    quint64 topLeft = m_grid.cellKey(reach.left(), reach.top());
+    quint64 bottomRight = m_grid.cellKey(reach.right(), reach.bottom());
+    
+    for (qint32 cellY = SpatialGrid::keyCellY(topLeft); cellY <= SpatialGrid::keyCellY(bottomRight); ++cellY) {
+        for (qint32 cellX = SpatialGrid::keyCellX(topLeft); cellX <= SpatialGrid::keyCellX(bottomRight); ++cellX) {
+            const QVector<int> *cell = m_grid.itemsInCell(SpatialGrid::packKey(cellX, cellY));
+            if (!cell) {
+                continue;
+            }
+            for (int j : *cell) {
+                if (reach.contains(x[j], y[j])) {
+                    report.vehiclePairs.append(qMakePair(PLAYER_VEHICLE, j));
+                }
+            }
+        }
+    }
+}
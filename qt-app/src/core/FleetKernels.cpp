@@ -0,0 +1,230 @@
+#include "core/FleetKernels.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FLEET_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FLEET_TARGET(isa)
+#else
+#define FLEET_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace FleetKernels
+{
+
+// Scalar reference. The comparisons are written the way MAXPD/MINPD
+// evaluate them so the vector paths match bit for bit.
+static Result integrateScalar(const Batch &batch, const Params &params, int first)
+{
+    double trackEnd = params.trackStart + params.trackLength;
+    Result result = { 0.0, 0.0 };
+    
+    for (int i = first; i < batch.count; ++i) {
+        double x = batch.positionX[i] + batch.speed[i] * params.deltaTime;
+        if (x >= trackEnd) {
+            x -= params.trackLength;
+        }
+        batch.positionX[i] = x;
+        
+        double v = (batch.speed[i] + batch.acceleration[i] * params.deltaTime) * params.frictionFactor;
+        v = v > 0.0 ? v : 0.0;
+        v = v < batch.maxSpeed[i] ? v : batch.maxSpeed[i];
+        batch.speed[i] = v;
+        
+        result.speedSum += v;
+        result.topSpeed = v > result.topSpeed ? v : result.topSpeed;
+    }
+    
+    return result;
+}
+
+#ifdef FLEET_KERNELS_X86
+
+FLEET_TARGET("sse4.1")
+static Result integrateSse41(const Batch &batch, const Params &params)
+{
+    const __m128d dt = _mm_set1_pd(params.deltaTime);
+    const __m128d friction = _mm_set1_pd(params.frictionFactor);
+    const __m128d trackEnd = _mm_set1_pd(params.trackStart + params.trackLength);
+    const __m128d trackLength = _mm_set1_pd(params.trackLength);
+    const __m128d zero = _mm_setzero_pd();
+    __m128d sum = _mm_setzero_pd();
+    __m128d top = _mm_setzero_pd();
+    
+    int i = 0;
+    for (; i + 2 <= batch.count; i += 2) {
+        __m128d v = _mm_loadu_pd(batch.speed + i);
+        __m128d x = _mm_add_pd(_mm_loadu_pd(batch.positionX + i), _mm_mul_pd(v, dt));
+        x = _mm_blendv_pd(x, _mm_sub_pd(x, trackLength), _mm_cmpge_pd(x, trackEnd));
+        _mm_storeu_pd(batch.positionX + i, x);
+        
+        v = _mm_mul_pd(_mm_add_pd(v, _mm_mul_pd(_mm_loadu_pd(batch.acceleration + i), dt)), friction);
+        v = _mm_min_pd(_mm_max_pd(v, zero), _mm_loadu_pd(batch.maxSpeed + i));
+        _mm_storeu_pd(batch.speed + i, v);
+        
+        sum = _mm_add_pd(sum, v);
+        top = _mm_max_pd(v, top);
+    }
+    
+    Result tail = integrateScalar(batch, params, i);
+    
+    double sums[2];
+    double tops[2];
+    _mm_storeu_pd(sums, sum);
+    _mm_storeu_pd(tops, top);
+    
+    Result result;
+    result.speedSum = sums[0] + sums[1] + tail.speedSum;
+    result.topSpeed = tops[0] > tops[1] ? tops[0] : tops[1];
+    result.topSpeed = tail.topSpeed > result.topSpeed ? tail.topSpeed : result.topSpeed;
+    return result;
+}
+
+FLEET_TARGET("avx2")
+static Result integrateAvx2(const Batch &batch, const Params &params)
+{
+    const __m256d dt = _mm256_set1_pd(params.deltaTime);
+    const __m256d friction = _mm256_set1_pd(params.frictionFactor);
+    const __m256d trackEnd = _mm256_set1_pd(params.trackStart + params.trackLength);
+    const __m256d trackLength = _mm256_set1_pd(params.trackLength);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d sum = _mm256_setzero_pd();
+    __m256d top = _mm256_setzero_pd();
+    
+    int i = 0;
+    for (; i + 4 <= batch.count; i += 4) {
+        __m256d v = _mm256_loadu_pd(batch.speed + i);
+        __m256d x = _mm256_add_pd(_mm256_loadu_pd(batch.positionX + i), _mm256_mul_pd(v, dt));
+        x = _mm256_blendv_pd(x, _mm256_sub_pd(x, trackLength), _mm256_cmp_pd(x, trackEnd, _CMP_GE_OQ));
+        _mm256_storeu_pd(batch.positionX + i, x);
+        
+        v = _mm256_mul_pd(_mm256_add_pd(v, _mm256_mul_pd(_mm256_loadu_pd(batch.acceleration + i), dt)), friction);
+        v = _mm256_min_pd(_mm256_max_pd(v, zero), _mm256_loadu_pd(batch.maxSpeed + i));
+        _mm256_storeu_pd(batch.speed + i, v);
+        
+        sum = _mm256_add_pd(sum, v);
+        top = _mm256_max_pd(v, top);
+    }
+    
+    Result tail = integrateScalar(batch, params, i);
+    
+    double sums[4];
+    double tops[4];
+    _mm256_storeu_pd(sums, sum);
+    _mm256_storeu_pd(tops, top);
+    
+    Result result;
+    result.speedSum = (sums[0] + sums[1]) + (sums[2] + sums[3]) + tail.speedSum;
+    result.topSpeed = tail.topSpeed;
+    for (double laneTop : tops) {
+        result.topSpeed = laneTop > result.topSpeed ? laneTop : result.topSpeed;
+    }
+    return result;
+}
+
+static bool cpuSupports(Path path)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (path == Path::Sse41) {
+        return sse41;
+    }
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    if (path == Path::Sse41) {
+        return __builtin_cpu_supports("sse4.1");
+    }
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+bool isPathSupported(Path path)
+{
+    if (path == Path::Scalar) {
+        return true;
+    }
+#ifdef FLEET_KERNELS_X86
+    static const bool sse41 = cpuSupports(Path::Sse41);
+    static const bool avx2 = cpuSupports(Path::Avx2);
+    return path == Path::Sse41 ? sse41 : avx2;
+#else
+    return false;
+#endif
+}
+
+Path bestSupportedPath()
+{
+    if (isPathSupported(Path::Avx2)) {
+        return Path::Avx2;
+    }
+    if (isPathSupported(Path::Sse41)) {
+        return Path::Sse41;
+    }
+    return Path::Scalar;
+}
+
+static std::atomic<int> s_activePath(-1);
+
+Path activePath()
+{
+    int path = s_activePath.load(std::memory_order_relaxed);
+    if (path < 0) {
+        path = int(bestSupportedPath());
+        s_activePath.store(path, std::memory_order_relaxed);
+    }
+    return Path(path);
+}
+
+void setActivePath(Path path)
+{
+    s_activePath.store(int(isPathSupported(path) ? path : bestSupportedPath()), std::memory_order_relaxed);
+}
+
+const char *pathName(Path path)
+{
+    switch (path) {
+    case Path::Avx2:
+        return "avx2";
+    case Path::Sse41:
+        return "sse4.1";
+    case Path::Scalar:
+        break;
+    }
+    return "scalar";
+}
+
+Result integrate(const Batch &batch, const Params &params)
+{
+    return integrate(activePath(), batch, params);
+}
+
+Result integrate(Path path, const Batch &batch, const Params &params)
+{
+#ifdef FLEET_KERNELS_X86
+    if (path == Path::Avx2 && isPathSupported(Path::Avx2)) {
+        return integrateAvx2(batch, params);
+    }
+    if (path == Path::Sse41 && isPathSupported(Path::Sse41)) {
+        return integrateSse41(batch, params);
+    }
+#else
+    (void)path;
+#endif
+    return integrateScalar(batch, params, 0);
+}
+
+}
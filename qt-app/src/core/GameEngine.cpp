@@ -1,16 +1,50 @@
 #include "core/GameEngine.h"
+#include "core/WorkStealingThreadPool.h"
+#include "core/SessionRecorder.h"
+#include <QDateTime>
+#include <QThread>
+#include <cmath>
+
+// m_friction is expressed per tick at this rate so it stays rate independent
+static const double FRICTION_REFERENCE_RATE = 60.0;
+
+// Past this x the road scrolls under the vehicle instead
+static const double VEHICLE_VIEW_ANCHOR = 400.0;
+
+// Half the report queue, leaving the rest for the player and for a
+// reporting thread that falls a frame behind
+static const int FLEET_REPORTS_PER_FRAME = 128;
 
 GameEngine::GameEngine(QObject *parent)
     : QObject(parent)
     , m_vehicle(nullptr)
+    , m_fleet(nullptr)
     , m_isRunning(false)
     , m_isPaused(false)
+    , m_externalClock(false)
     , m_gameTimer(nullptr)
     , m_elapsedTimer(nullptr)
     , m_lastUpdateTime(0.0)
     , m_gameSpeed(1.0)
     , m_speedMultiplier(1.0)
     , m_targetFPS(60)
+    , m_fixedTimestepEnabled(true)
+    , m_physicsRate(60)
+    , m_fixedTimeStep(1.0 / 60)
+    , m_maxCatchUpSteps(8)
+    , m_accumulator(0.0)
+    , m_interpolationAlpha(0.0)
+    , m_droppedTime(0.0)
+    , m_simulationTick(0)
+    , m_simulationTime(0.0)
+    , m_fleetReporting(false)
+    , m_fleetReportCursor(0)
+    , m_workerThreadCount(qMax(0, QThread::idealThreadCount() - 1))
+    , m_batchFleetSteps(false)
+    , m_pendingFleetSteps(0)
+    , m_checkedFleetVersion(0)
+    , m_playerOffRoad(false)
+    , m_sessionRecorder(nullptr)
     , m_gravity(0.0)
     , m_friction(0.98)
 {
@@ -20,40 +54,69 @@ GameEngine::GameEngine(QObject *parent)
     
    
     m_gameTimer->setInterval(1000 / m_targetFPS);
+    m_gameTimer->setTimerType(Qt::PreciseTimer);
     connect(m_gameTimer, &QTimer::timeout, this, &GameEngine::gameLoop);
     
    
     m_vehicle = new VehicleModel(this);
-    m_speedReportingService = new SpeedReportingService(this);
-  
-    
-   
-    setupConnections();
+    m_fleet = new FleetModel(this);
     
-    m_speedReportingService->startReporting();
+    // Reporting gets its own event loop so DNS lookups and socket
+    // backpressure never stall a frame; samples reach it through the
+    // service's lock-free queue
+    m_speedReportingService = new SpeedReportingService();
+    m_reportingThread = new QThread(this);
+    m_reportingThread->setObjectName("SpeedReporting");
+    m_speedReportingService->moveToThread(m_reportingThread);
+    connect(m_reportingThread, &QThread::finished, m_speedReportingService, &QObject::deleteLater);
+    m_reportingThread->start();
     
+    qRegisterMetaType<FrameSnapshot>();
 }
 
 GameEngine::~GameEngine()
 {
     stopGame();
+    // The service is deleted on its own thread as the thread finishes
+    m_reportingThread->quit();
+    m_reportingThread->wait();
+    // The pool goes away before the fleet does; nothing may still run on it
+    m_fleet->setThreadPool(nullptr);
 }
 
 void GameEngine::startGame()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, &GameEngine::startGame, Qt::QueuedConnection);
+        return;
+    }
+    
     if (!m_isRunning) {
         m_isRunning = true;
         m_isPaused = false;
         m_elapsedTimer->start();
         m_lastUpdateTime = 0.0;
+        m_accumulator = 0.0;
+        m_interpolationAlpha = 0.0;
+        m_droppedTime = 0.0;
+        m_simulationTick = 0;
+        m_simulationTime = 0.0;
+        m_pendingInputs.clear();
         
        
         if (m_vehicle) {
             m_vehicle->start();
+            m_previousVehiclePosition = m_vehicle->position();
+        }
+        
+        if (m_sessionRecorder) {
+            m_sessionRecorder->beginSession(sessionHeader());
         }
         
        
-        m_gameTimer->start();
+        if (!m_externalClock) {
+            m_gameTimer->start();
+        }
         
         emit gameStarted();
     }
@@ -61,15 +124,27 @@ void GameEngine::startGame()
 
 void GameEngine::stopGame()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, &GameEngine::stopGame, Qt::QueuedConnection);
+        return;
+    }
+    
     if (m_isRunning) {
         m_isRunning = false;
         m_isPaused = false;
         m_gameTimer->stop();
+        flushFleetSteps();
+        m_pendingInputs.clear();
+        
+        if (m_sessionRecorder) {
+            m_sessionRecorder->endSession(m_simulationTick);
+        }
         
        
         if (m_vehicle) {
             m_vehicle->stop();
         }
+        render();
         
         emit gameStopped();
     }
@@ -77,6 +152,11 @@ void GameEngine::stopGame()
 
 void GameEngine::pauseGame()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, &GameEngine::pauseGame, Qt::QueuedConnection);
+        return;
+    }
+    
     if (m_isRunning && !m_isPaused) {
         m_isPaused = true;
         m_gameTimer->stop();
@@ -87,9 +167,18 @@ void GameEngine::pauseGame()
 
 void GameEngine::resumeGame()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, &GameEngine::resumeGame, Qt::QueuedConnection);
+        return;
+    }
+    
     if (m_isRunning && m_isPaused) {
         m_isPaused = false;
-        m_gameTimer->start();
+        // Don't let the paused interval show up as one huge frame
+        m_lastUpdateTime = m_elapsedTimer->elapsed();
+        if (!m_externalClock) {
+            m_gameTimer->start();
+        }
         emit gameResumed();
        
     }
@@ -104,54 +193,458 @@ void GameEngine::update(double deltaTime)
    
     deltaTime *= m_speedMultiplier;
     
+    stepSimulation(deltaTime);
+    checkCollisions();
+}
+
+void GameEngine::advanceFrame(double frameTime)
+{
+    if (!m_isRunning || m_isPaused) {
+        return;
+    }
+    
+    if (!m_fixedTimestepEnabled) {
+        update(qMin(frameTime, 0.1));
+        m_interpolationAlpha = 1.0;
+        render();
+        return;
+    }
+    
+    // Game speed scales how much simulated time a frame produces, never the
+    // step size, so a run is a pure function of the number of steps taken.
+    m_accumulator += frameTime * m_speedMultiplier;
+    
+    double maxFrameBudget = m_fixedTimeStep * m_maxCatchUpSteps;
+    if (m_accumulator > maxFrameBudget) {
+        m_droppedTime += m_accumulator - maxFrameBudget;
+        m_accumulator = maxFrameBudget;
+    }
+    
+    m_batchFleetSteps = true;
+    while (m_accumulator >= m_fixedTimeStep) {
+        stepSimulation(m_fixedTimeStep);
+        m_accumulator -= m_fixedTimeStep;
+    }
+    m_batchFleetSteps = false;
+    syncFleet();
+    
+    m_interpolationAlpha = m_accumulator / m_fixedTimeStep;
+    render();
+}
+
+QPointF GameEngine::interpolatedVehiclePosition() const
+{
+    if (!m_vehicle) {
+        return QPointF();
+    }
+    
+    QPointF current = m_vehicle->position();
+    return m_previousVehiclePosition + (current - m_previousVehiclePosition) * m_interpolationAlpha;
+}
+
+void GameEngine::render()
+{
+    // Drawing is handled by the GameView; the engine publishes one snapshot
+    // per frame, blended between the last two physics steps, and only then
+    // lets the models emit their own notifications.
+    FrameSnapshot snapshot;
+    snapshot.tick = m_simulationTick;
+    snapshot.simulationTime = m_simulationTime;
+    snapshot.interpolationAlpha = m_interpolationAlpha;
+    
+    if (m_vehicle) {
+        quint32 vehicleChanges = m_vehicle->pendingChanges();
+        if (vehicleChanges & VehicleModel::PositionChange) {
+            snapshot.changes |= FrameSnapshot::VehiclePositionChanged;
+        }
+        if (vehicleChanges & VehicleModel::SpeedChange) {
+            snapshot.changes |= FrameSnapshot::VehicleSpeedChanged;
+        }
+        snapshot.vehiclePosition = interpolatedVehiclePosition();
+        snapshot.vehicleSpeed = m_vehicle->speed();
+    }
+    
+    if (m_fleet->hasPendingChanges()) {
+        snapshot.changes |= FrameSnapshot::FleetChanged;
+    }
+    snapshot.fleetSize = m_fleet->vehicleCount();
+    snapshot.fleetAverageSpeed = m_fleet->averageSpeed();
+    snapshot.fleetTopSpeed = m_fleet->topSpeed();
+    
+    m_publishedFrame.snapshot = snapshot;
+    ++m_publishedFrame.frame;
+    for (int bit = 0; bit < FrameSnapshot::CHANGE_BIT_COUNT; ++bit) {
+        if (snapshot.changes & (1u << bit)) {
+            m_publishedFrame.changedOn[bit] = m_publishedFrame.frame;
+        }
+    }
+    m_snapshotBuffer.publish(m_publishedFrame);
+    emit frameReady(snapshot);
+    
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    if (snapshot.hasChanged(FrameSnapshot::VehicleSpeedChanged)) {
+        emit speedChanged(snapshot.vehicleSpeed);
+        m_speedReportingService->enqueueSpeed(SpeedSample::PLAYER_VEHICLE, snapshot.vehicleSpeed, timestamp);
+    }
+    if (m_fleetReporting && snapshot.hasChanged(FrameSnapshot::FleetChanged)) {
+        reportFleetSpeeds(timestamp);
+    }
+    
+    if (m_vehicle) {
+        m_vehicle->publishChanges();
+    }
+    m_fleet->publishChanges();
+}
+
+void GameEngine::reportFleetSpeeds(qint64 timestamp)
+{
+    int count = m_fleet->vehicleCount();
+    if (m_reportedFleetSpeeds.size() != count) {
+        // A resized fleet is a new fleet: every vehicle reports once
+        m_reportedFleetSpeeds.fill(std::nan(""), count);
+        m_fleetReportCursor = 0;
+    }
+    if (count == 0) {
+        return;
+    }
+    
+    // Reads the published speeds, which a running batch never writes
+    const double *speeds = m_fleet->speeds();
+    double *reported = m_reportedFleetSpeeds.data();
+    int scan = qMin(count, FLEET_REPORTS_PER_FRAME);
+    for (int i = 0; i < scan; ++i) {
+        int index = m_fleetReportCursor;
+        m_fleetReportCursor = m_fleetReportCursor + 1 < count ? m_fleetReportCursor + 1 : 0;
+        if (speeds[index] != reported[index]) {
+            reported[index] = speeds[index];
+            m_speedReportingService->enqueueSpeed(index, speeds[index], timestamp);
+        }
+    }
+}
+
+FrameSnapshot GameEngine::latestSnapshot(SnapshotCursor &cursor)
+{
+    // A flag counts as changed if it went up on any frame this reader has
+    // not seen, including frames the buffer skipped over
+    const PublishedFrame &published = m_snapshotBuffer.latest();
+    FrameSnapshot latest = published.snapshot;
+    latest.changes = 0;
+    for (int bit = 0; bit < FrameSnapshot::CHANGE_BIT_COUNT; ++bit) {
+        if (published.changedOn[bit] > cursor.frame) {
+            latest.changes |= 1u << bit;
+        }
+    }
+    cursor.frame = published.frame;
+    return latest;
+}
+
+void GameEngine::setExternalClockEnabled(bool enabled)
+{
+    // With an external clock the caller drives advanceFrame() itself, e.g.
+    // a headless runner stepping faster than real time.
+    m_externalClock = enabled;
+    if (m_externalClock) {
+        m_gameTimer->stop();
+    } else if (m_isRunning && !m_isPaused) {
+        m_lastUpdateTime = m_elapsedTimer->elapsed();
+        m_gameTimer->start();
+    }
+}
+
+void GameEngine::setFixedTimestepEnabled(bool enabled)
+{
+    flushFleetSteps();
+    m_fixedTimestepEnabled = enabled;
+    m_accumulator = 0.0;
+}
+
+void GameEngine::setPhysicsRate(int hz)
+{
+    flushFleetSteps();
+    m_physicsRate = qBound(10, hz, 1000);
+    m_fixedTimeStep = 1.0 / m_physicsRate;
+    m_accumulator = 0.0;
+}
+
+void GameEngine::setMaxCatchUpSteps(int steps)
+{
+    m_maxCatchUpSteps = qMax(1, steps);
+}
+
+void GameEngine::stepSimulation(double deltaTime)
+{
+    applyPendingInputs();
+    
+    if (m_vehicle) {
+        m_previousVehiclePosition = m_vehicle->position();
+    }
+    
     updateGameObjects(deltaTime);
     updatePhysics(deltaTime);
+    
+    // The player's road check stays per step so its penalty never depends
+    // on how steps were grouped into frames.
+    if (m_vehicle && !m_collisionDetector.roadBounds().contains(m_vehicle->boundingRect())) {
+        handleVehicleOffRoad();
+    }
+    
+    ++m_simulationTick;
+    m_simulationTime += deltaTime;
+    
+    if (m_sessionRecorder && m_vehicle) {
+        m_sessionRecorder->recordState(m_simulationTick, deltaTime, m_vehicle->position(), m_vehicle->speed());
+    }
+}
+
+void GameEngine::replayStep(double deltaTime)
+{
+    if (!m_isRunning) {
+        return;
+    }
+    
+    // Fleet steps can only be batched at the fixed step size
+    bool batch = deltaTime == m_fixedTimeStep;
+    if (!batch) {
+        flushFleetSteps();
+    }
+    
+    m_batchFleetSteps = batch;
+    stepSimulation(deltaTime);
+    m_batchFleetSteps = false;
+    syncFleet();
+}
+
+void GameEngine::requestVehicleSpeed(double speed)
+{
+    queueInput({ SimulationInput::SetSpeed, speed, 0.0 });
+}
+
+void GameEngine::accelerateVehicle()
+{
+    queueInput({ SimulationInput::Accelerate, 0.0, 0.0 });
+}
+
+void GameEngine::decelerateVehicle()
+{
+    queueInput({ SimulationInput::Decelerate, 0.0, 0.0 });
+}
+
+void GameEngine::requestVehiclePosition(const QPointF &position)
+{
+    queueInput({ SimulationInput::SetPosition, position.x(), position.y() });
+}
+
+void GameEngine::queueInput(const SimulationInput &input)
+{
+    // Controls may be driven from the GUI thread; inputs are only ever
+    // touched on the engine's own.
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, input]() { queueInput(input); }, Qt::QueuedConnection);
+        return;
+    }
+    
+    // Outside a run there is no step to wait for
+    if (m_isRunning) {
+        m_pendingInputs.append(input);
+    } else {
+        applyInput(input);
+        render();
+    }
+}
+
+void GameEngine::applyPendingInputs()
+{
+    for (const SimulationInput &input : m_pendingInputs) {
+        if (m_sessionRecorder) {
+            m_sessionRecorder->recordInput(m_simulationTick, input);
+        }
+        applyInput(input);
+    }
+    m_pendingInputs.clear();
+}
+
+void GameEngine::applyInput(const SimulationInput &input)
+{
+    if (!m_vehicle) {
+        return;
+    }
+    
+    switch (input.type) {
+    case SimulationInput::SetSpeed:
+        m_vehicle->setSpeed(input.x);
+        break;
+    case SimulationInput::Accelerate:
+        m_vehicle->accelerate();
+        break;
+    case SimulationInput::Decelerate:
+        m_vehicle->decelerate();
+        break;
+    case SimulationInput::SetPosition:
+        m_vehicle->setPosition(QPointF(input.x, input.y));
+        keepVehicleInView();
+        break;
+    }
+}
+
+SessionHeader GameEngine::sessionHeader() const
+{
+    SessionHeader header;
+    header.physicsRate = m_physicsRate;
+    if (m_vehicle) {
+        header.vehiclePosition = m_vehicle->position();
+        header.vehicleSpeed = m_vehicle->speed();
+    }
+    header.fleetSize = m_fleet->vehicleCount();
+    header.fleetSeed = m_fleet->seed();
+    header.laneCount = m_fleet->laneCount();
+    header.roadBounds = m_collisionDetector.roadBounds();
+    return header;
+}
+
+double GameEngine::frictionFactor(double deltaTime) const
+{
+    return std::pow(m_friction, deltaTime * FRICTION_REFERENCE_RATE);
+}
+
+void GameEngine::syncFleet()
+{
+    // The previous frame's batch must be in before collisions are checked;
+    // checking whichever batch happened to be done would tie the steps
+    // that get checked, and penalised, to thread timing.
+    m_fleet->waitForSteps();
+    
+    // Runs on the finished snapshot, before the next batch starts from it
     checkCollisions();
+    
+    if (m_pendingFleetSteps > 0) {
+        m_fleet->beginSteps(m_pendingFleetSteps, m_fixedTimeStep, frictionFactor(m_fixedTimeStep));
+        m_pendingFleetSteps = 0;
+        // Without worker threads the batch has already finished
+        m_fleet->collectSteps();
+    }
 }
 
-void GameEngine::render()
+void GameEngine::flushFleetSteps()
 {
-    // Rendering is handled by the GameView
-    // This method can be used for any engine-level rendering if needed
+    if (m_pendingFleetSteps > 0) {
+        m_fleet->beginSteps(m_pendingFleetSteps, m_fixedTimeStep, frictionFactor(m_fixedTimeStep));
+        m_pendingFleetSteps = 0;
+    }
+    m_fleet->waitForSteps();
 }
 
 void GameEngine::updatePhysics(double deltaTime)
 {
+    double friction = frictionFactor(deltaTime);
+    
+    if (m_batchFleetSteps) {
+        ++m_pendingFleetSteps;
+    } else {
+        m_fleet->updatePhysics(deltaTime, friction);
+    }
+    
     if (!m_vehicle) {
         return;
     }
     
    
     m_vehicle->updatePosition(deltaTime);
+    keepVehicleInView();
     
     
     if (m_vehicle->speed() > 0) {
-        double newSpeed = m_vehicle->speed() * m_friction;
+        double newSpeed = m_vehicle->speed() * friction;
         m_vehicle->setSpeed(newSpeed);
     }
 }
 
 void GameEngine::checkCollisions()
 {
-   
-    return;
+    CollisionReport report;
     
-    if (!m_vehicle) {
+    // While a batch is still running the published positions are the ones
+    // already checked, so only the player needs testing.
+    if (!m_fleet->isStepInFlight() && m_fleet->positionVersion() != m_checkedFleetVersion) {
+        m_collisionDetector.detectFleet(*m_fleet, report);
+        m_checkedFleetVersion = m_fleet->positionVersion();
+    }
+    
+    if (m_vehicle) {
+        m_collisionDetector.detectPlayer(*m_fleet, m_vehicle->boundingRect(), report);
+    }
+    
+    report.playerOffRoad = m_playerOffRoad;
+    m_playerOffRoad = false;
+    
+    if (report.isEmpty()) {
         return;
     }
-    QPointF vehiclePos = m_vehicle->position();
-    QSizeF vehicleSize = m_vehicle->size();
-    QRectF roadArea(0, 250, 2000, 100); // Wider road area for collision
-    QRectF vehicleBounds(vehiclePos.x() - vehicleSize.width() / 2,
-                        vehiclePos.y() - vehicleSize.height() / 2,
-                        vehicleSize.width(), vehicleSize.height());
-    if (!roadArea.contains(vehicleBounds)) {
-        handleVehicleOffRoad();
+    
+    // Fleet vehicles that leave the road get the same penalty as the player
+    for (int index : report.offRoadVehicles) {
+        m_fleet->setSpeed(index, m_fleet->speeds()[index] * 0.5);
+    }
+    
+    if (!report.vehiclePairs.isEmpty()) {
+        emit collisionsDetected(report.vehiclePairs);
+        emit collisionDetected();
+    }
+    if (!report.offRoadVehicles.isEmpty()) {
+        emit vehiclesOffRoad(report.offRoadVehicles);
+    }
+    if (report.playerOffRoad) {
+        emit vehicleOffRoad();
+    }
+}
+
+void GameEngine::setRoadBounds(const QRectF &bounds)
+{
+    m_fleet->waitForSteps();
+    m_pendingFleetSteps = 0;
+    m_collisionDetector.setRoadBounds(bounds);
+    m_fleet->setRoadBounds(bounds);
+}
+
+void GameEngine::setFleetSize(int vehicleCount)
+{
+    // Resizing respawns the fleet, so steps queued for the old one are moot
+    m_fleet->waitForSteps();
+    m_pendingFleetSteps = 0;
+    m_fleet->resize(vehicleCount);
+    setWorkerThreadCount(m_workerThreadCount);
+}
+
+void GameEngine::setWorkerThreadCount(int count)
+{
+    count = qMax(0, count);
+    
+    // Threads are only started once there is a fleet to run on them
+    bool wantPool = count > 0 && m_fleet->vehicleCount() > 0;
+    bool unchanged = wantPool ? m_threadPool && m_threadPool->threadCount() == count : !m_threadPool;
+    m_workerThreadCount = count;
+    if (unchanged) {
+        return;
+    }
+    
+    flushFleetSteps();
+    m_fleet->setThreadPool(nullptr);
+    m_collisionDetector.setThreadPool(nullptr);
+    m_threadPool.reset();
+    
+    if (wantPool) {
+        m_threadPool = std::make_unique<WorkStealingThreadPool>(count);
+        m_fleet->setThreadPool(m_threadPool.get());
+        m_collisionDetector.setThreadPool(m_threadPool.get());
     }
 }
 
 void GameEngine::setSpeedMultiplier(double multiplier)
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, multiplier]() { setSpeedMultiplier(multiplier); }, Qt::QueuedConnection);
+        return;
+    }
+    
     m_speedMultiplier = qBound(0.1, multiplier, 5.0);
 }
 
@@ -168,64 +661,28 @@ void GameEngine::gameLoop()
     
    
     qint64 currentTime = m_elapsedTimer->elapsed();
-    double deltaTime = (currentTime - m_lastUpdateTime) / 1000.0; 
+    double frameTime = (currentTime - m_lastUpdateTime) / 1000.0; 
     m_lastUpdateTime = currentTime;
     
-    
-    deltaTime = qMin(deltaTime, 0.1);
-    
-    
-    update(deltaTime);
+    advanceFrame(frameTime);
 }
 
-void GameEngine::onVehiclePositionChanged(const QPointF &position)
+void GameEngine::keepVehicleInView()
 {
-    
-    if ( position.x() > 400) { 
-        double scrollOffset = position.x() - 400;
-       
-        
-        
-        m_vehicle->setPosition(QPointF(400, position.y()));
+    QPointF position = m_vehicle->position();
+    if (position.x() > VEHICLE_VIEW_ANCHOR) {
+        m_vehicle->setPosition(QPointF(VEHICLE_VIEW_ANCHOR, position.y()));
     }
 }
 
-void GameEngine::onVehicleSpeedChanged(double speed)
-{
-    emit speedChanged(speed);
-    m_speedReportingService->onSpeedChanged(speed);
-}
-
 void GameEngine::initializeGame()
 {
-   
-    if (m_vehicle) {
-        m_vehicle->loadSprites();
-      
-    }
-    
-    
-
-    
-    
     if (m_vehicle) {
         m_vehicle->setPosition(QPointF(100, 700)); 
         m_vehicle->setSpeed(0.0);
     }
     
  
-}
-
-void GameEngine::setupConnections()
-{
-    if (m_vehicle) {
-        connect(m_vehicle, &VehicleModel::positionChanged,
-                this, &GameEngine::onVehiclePositionChanged);
-        connect(m_vehicle, &VehicleModel::speedChanged,
-                this, &GameEngine::onVehicleSpeedChanged);
-    }
-    
-   
 }
 
 void GameEngine::updateGameObjects(double deltaTime)
@@ -236,7 +693,8 @@ void GameEngine::updateGameObjects(double deltaTime)
 
 void GameEngine::handleVehicleOffRoad()
 {
-    emit vehicleOffRoad();
+    // Reported once per frame from checkCollisions()
+    m_playerOffRoad = true;
     
     if (m_vehicle) {
         m_vehicle->setSpeed(m_vehicle->speed() * 0.5);
@@ -0,0 +1,226 @@
+#include "core/SessionPlayer.h"
+#include "core/GameEngine.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+
+SessionPlayer::SessionPlayer()
+    : m_offset(0)
+    , m_truncated(false)
+    , m_expectedSpeed(0.0)
+    , m_ticksReplayed(0)
+    , m_inputsReplayed(0)
+    , m_divergentTicks(0)
+    , m_firstDivergentTick(0)
+{
+}
+
+bool SessionPlayer::open(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    
+    m_data = file.readAll();
+    m_offset = 0;
+    m_truncated = false;
+    
+    if (readUInt32() != SessionRecorder::MAGIC) {
+        m_errorString = "Not a session log";
+        return false;
+    }
+    quint16 version = readUInt16();
+    if (version != SessionRecorder::VERSION) {
+        m_errorString = QString("Unsupported session log version %1").arg(version);
+        return false;
+    }
+    
+    m_header.physicsRate = int(readUInt32());
+    double x = readDouble();
+    double y = readDouble();
+    m_header.vehiclePosition = QPointF(x, y);
+    m_header.vehicleSpeed = readDouble();
+    m_header.fleetSize = int(readUInt32());
+    m_header.fleetSeed = readUInt32();
+    m_header.laneCount = int(readUInt32());
+    double left = readDouble();
+    double top = readDouble();
+    double width = readDouble();
+    double height = readDouble();
+    m_header.roadBounds = QRectF(left, top, width, height);
+    
+    if (m_truncated) {
+        m_errorString = "Session log header is truncated";
+        return false;
+    }
+    
+    return true;
+}
+
+void SessionPlayer::configure(GameEngine &engine) const
+{
+    engine.stopGame();
+    engine.setExternalClockEnabled(true);
+    engine.setPhysicsRate(m_header.physicsRate);
+    engine.fleet()->setSeed(m_header.fleetSeed);
+    engine.fleet()->setLaneCount(m_header.laneCount);
+    engine.setRoadBounds(m_header.roadBounds);
+    engine.setFleetSize(m_header.fleetSize);
+    
+    engine.startGame();
+    engine.vehicle()->setPosition(m_header.vehiclePosition);
+    engine.vehicle()->setSpeed(m_header.vehicleSpeed);
+}
+
+bool SessionPlayer::replay(GameEngine &engine)
+{
+    m_expectedPosition = m_header.vehiclePosition;
+    m_expectedSpeed = m_header.vehicleSpeed;
+    m_ticksReplayed = 0;
+    m_inputsReplayed = 0;
+    m_divergentTicks = 0;
+    m_firstDivergentTick = 0;
+    
+    double fixedTimeStep = 1.0 / m_header.physicsRate;
+    quint64 tick = 0;
+    
+    while (m_offset < m_data.size()) {
+        quint8 kind = readByte();
+        tick += readVarint();
+        
+        if (kind == SessionRecorder::InputRecord) {
+            SimulationInput input;
+            input.type = SimulationInput::Type(readByte());
+            input.x = readDouble();
+            input.y = input.type == SimulationInput::SetPosition ? readDouble() : 0.0;
+            if (m_truncated) {
+                break;
+            }
+            
+            stepTo(engine, tick);
+            engine.queueInput(input);
+            ++m_inputsReplayed;
+        } else if (kind == SessionRecorder::StateRecord) {
+            quint8 mask = readByte();
+            double deltaTime = mask & SessionRecorder::StepField ? readDouble() : fixedTimeStep;
+            QPointF position = m_expectedPosition;
+            double speed = m_expectedSpeed;
+            if (mask & SessionRecorder::PositionXField) {
+                position.setX(readDouble());
+            }
+            if (mask & SessionRecorder::PositionYField) {
+                position.setY(readDouble());
+            }
+            if (mask & SessionRecorder::SpeedField) {
+                speed = readDouble();
+            }
+            if (m_truncated || tick == 0) {
+                break;
+            }
+            
+            // Steps in between left the vehicle untouched and wrote nothing
+            stepTo(engine, tick - 1);
+            m_expectedPosition = position;
+            m_expectedSpeed = speed;
+            step(engine, deltaTime);
+        } else if (kind == SessionRecorder::EndRecord) {
+            stepTo(engine, tick);
+            return true;
+        } else {
+            m_errorString = QString("Unknown record kind %1 at offset %2").arg(kind).arg(m_offset - 1);
+            return false;
+        }
+    }
+    
+    // A log without an end record is still replayed up to where it stops
+    m_errorString = m_truncated ? "Session log is truncated" : "Session log has no end record";
+    return false;
+}
+
+void SessionPlayer::stepTo(GameEngine &engine, quint64 tick)
+{
+    double fixedTimeStep = 1.0 / m_header.physicsRate;
+    while (engine.isRunning() && engine.simulationTick() < tick) {
+        step(engine, fixedTimeStep);
+    }
+}
+
+void SessionPlayer::step(GameEngine &engine, double deltaTime)
+{
+    engine.replayStep(deltaTime);
+    ++m_ticksReplayed;
+    
+    VehicleModel *vehicle = engine.vehicle();
+    if (vehicle->position() != m_expectedPosition || vehicle->speed() != m_expectedSpeed) {
+        if (m_divergentTicks == 0) {
+            m_firstDivergentTick = engine.simulationTick();
+        }
+        ++m_divergentTicks;
+        // Carry on from the replayed state so one mismatch isn't counted forever
+        m_expectedPosition = vehicle->position();
+        m_expectedSpeed = vehicle->speed();
+    }
+}
+
+quint8 SessionPlayer::readByte()
+{
+    if (m_offset + 1 > m_data.size()) {
+        m_truncated = true;
+        m_offset = m_data.size();
+        return 0;
+    }
+    return quint8(m_data.at(m_offset++));
+}
+
+quint16 SessionPlayer::readUInt16()
+{
+    if (m_offset + 2 > m_data.size()) {
+        m_truncated = true;
+        m_offset = m_data.size();
+        return 0;
+    }
+    quint16 value = qFromLittleEndian<quint16>(m_data.constData() + m_offset);
+    m_offset += 2;
+    return value;
+}
+
+quint32 SessionPlayer::readUInt32()
+{
+    if (m_offset + 4 > m_data.size()) {
+        m_truncated = true;
+        m_offset = m_data.size();
+        return 0;
+    }
+    quint32 value = qFromLittleEndian<quint32>(m_data.constData() + m_offset);
+    m_offset += 4;
+    return value;
+}
+
+double SessionPlayer::readDouble()
+{
+    if (m_offset + 8 > m_data.size()) {
+        m_truncated = true;
+        m_offset = m_data.size();
+        return 0.0;
+    }
+    quint64 bits = qFromLittleEndian<quint64>(m_data.constData() + m_offset);
+    m_offset += 8;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+quint64 SessionPlayer::readVarint()
+{
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        quint8 byte = readByte();
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
@@ -0,0 +1,192 @@
+#include "core/SessionRecorder.h"
+#include <QtEndian>
+#include <cstring>
+
+const quint32 SessionRecorder::MAGIC = 0x52535356; // "VSSR" read as little-endian
+const quint16 SessionRecorder::VERSION = 1;
+
+// Records are collected in memory and written out in blocks of this size
+static const int FLUSH_THRESHOLD = 64 * 1024;
+
+SessionRecorder::SessionRecorder()
+    : m_bytesWritten(0)
+    , m_sessionOpen(false)
+    , m_lastTick(0)
+    , m_fixedTimeStep(0.0)
+    , m_lastSpeed(0.0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+bool SessionRecorder::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    m_bytesWritten = 0;
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+void SessionRecorder::close()
+{
+    if (m_file.isOpen()) {
+        flush();
+        m_file.close();
+    }
+    m_sessionOpen = false;
+}
+
+void SessionRecorder::beginSession(const SessionHeader &header)
+{
+    if (!isOpen() || m_sessionOpen) {
+        return;
+    }
+    
+    writeUInt32(MAGIC);
+    writeUInt16(VERSION);
+    writeUInt32(quint32(header.physicsRate));
+    writeDouble(header.vehiclePosition.x());
+    writeDouble(header.vehiclePosition.y());
+    writeDouble(header.vehicleSpeed);
+    writeUInt32(quint32(header.fleetSize));
+    writeUInt32(header.fleetSeed);
+    writeUInt32(quint32(header.laneCount));
+    writeDouble(header.roadBounds.x());
+    writeDouble(header.roadBounds.y());
+    writeDouble(header.roadBounds.width());
+    writeDouble(header.roadBounds.height());
+    
+    m_sessionOpen = true;
+    m_lastTick = 0;
+    m_fixedTimeStep = 1.0 / header.physicsRate;
+    m_lastPosition = header.vehiclePosition;
+    m_lastSpeed = header.vehicleSpeed;
+}
+
+void SessionRecorder::recordInput(quint64 tick, const SimulationInput &input)
+{
+    if (!m_sessionOpen) {
+        return;
+    }
+    
+    writeRecord(InputRecord, tick);
+    writeByte(input.type);
+    writeDouble(input.x);
+    if (input.type == SimulationInput::SetPosition) {
+        writeDouble(input.y);
+    }
+}
+
+void SessionRecorder::recordState(quint64 tick, double deltaTime, const QPointF &position, double speed)
+{
+    if (!m_sessionOpen) {
+        return;
+    }
+    
+    // Exact comparisons on purpose: replay has to reproduce every bit
+    quint8 mask = 0;
+    if (deltaTime != m_fixedTimeStep) {
+        mask |= StepField;
+    }
+    if (position.x() != m_lastPosition.x()) {
+        mask |= PositionXField;
+    }
+    if (position.y() != m_lastPosition.y()) {
+        mask |= PositionYField;
+    }
+    if (speed != m_lastSpeed) {
+        mask |= SpeedField;
+    }
+    
+    if (mask == 0) {
+        return;
+    }
+    
+    writeRecord(StateRecord, tick);
+    writeByte(mask);
+    if (mask & StepField) {
+        writeDouble(deltaTime);
+    }
+    if (mask & PositionXField) {
+        writeDouble(position.x());
+    }
+    if (mask & PositionYField) {
+        writeDouble(position.y());
+    }
+    if (mask & SpeedField) {
+        writeDouble(speed);
+    }
+    
+    m_lastPosition = position;
+    m_lastSpeed = speed;
+}
+
+void SessionRecorder::endSession(quint64 tick)
+{
+    if (!m_sessionOpen) {
+        return;
+    }
+    
+    writeRecord(EndRecord, tick);
+    flush();
+    m_sessionOpen = false;
+}
+
+void SessionRecorder::writeRecord(RecordKind kind, quint64 tick)
+{
+    writeByte(kind);
+    writeVarint(tick - m_lastTick);
+    m_lastTick = tick;
+    
+    if (m_buffer.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
+}
+
+void SessionRecorder::writeByte(quint8 value)
+{
+    m_buffer.append(char(value));
+}
+
+void SessionRecorder::writeUInt16(quint16 value)
+{
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    m_buffer.append(bytes, sizeof(bytes));
+}
+
+void SessionRecorder::writeUInt32(quint32 value)
+{
+    char bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    m_buffer.append(bytes, sizeof(bytes));
+}
+
+void SessionRecorder::writeDouble(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    char bytes[sizeof(bits)];
+    qToLittleEndian(bits, bytes);
+    m_buffer.append(bytes, sizeof(bytes));
+}
+
+void SessionRecorder::writeVarint(quint64 value)
+{
+    while (value >= 0x80) {
+        m_buffer.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    m_buffer.append(char(value));
+}
+
+void SessionRecorder::flush()
+{
+    if (!m_buffer.isEmpty() && m_file.isOpen()) {
+        m_bytesWritten += m_file.write(m_buffer);
+        m_buffer.resize(0);
+    }
+}
@@ -0,0 +1,98 @@
+#include "core/SpatialGrid.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(double cellSize)
+    : m_cellSize(cellSize)
+    , m_inverseCellSize(1.0 / cellSize)
+{
+}
+
+void SpatialGrid::setCellSize(double size)
+{
+    if (size > 0.0 && size != m_cellSize) {
+        m_cellSize = size;
+        m_inverseCellSize = 1.0 / size;
+        clear();
+    }
+}
+
+void SpatialGrid::clear()
+{
+    m_cells.clear();
+    m_itemCell.clear();
+    m_itemSlot.clear();
+}
+
+quint64 SpatialGrid::cellKey(double x, double y) const
+{
+    return packKey(qint32(std::floor(x * m_inverseCellSize)),
+                   qint32(std::floor(y * m_inverseCellSize)));
+}
+
+quint64 SpatialGrid::packKey(qint32 cellX, qint32 cellY)
+{
+    return (quint64(quint32(cellX)) << 32) | quint32(cellY);
+}
+
+int SpatialGrid::update(const quint64 *cellKeys, int count)
+{
+    int oldCount = m_itemCell.size();
+    int moved = 0;
+    
+    for (int item = oldCount - 1; item >= count; --item) {
+        remove(item);
+    }
+    
+    m_itemCell.resize(count);
+    m_itemSlot.resize(count);
+    
+    int kept = qMin(oldCount, count);
+    for (int item = 0; item < kept; ++item) {
+        if (m_itemCell[item] != cellKeys[item]) {
+            remove(item);
+            insert(item, cellKeys[item]);
+            ++moved;
+        }
+    }
+    
+    for (int item = kept; item < count; ++item) {
+        insert(item, cellKeys[item]);
+        ++moved;
+    }
+    
+    return moved;
+}
+
+const QVector<int> *SpatialGrid::itemsInCell(quint64 key) const
+{
+    auto it = m_cells.constFind(key);
+    return it != m_cells.constEnd() ? &it.value() : nullptr;
+}
+
+void SpatialGrid::insert(int item, quint64 key)
+{
+    QVector<int> &cell = m_cells[key];
+    m_itemCell[item] = key;
+    m_itemSlot[item] = cell.size();
+    cell.append(item);
+}
+
+void SpatialGrid::remove(int item)
+{
+    auto it = m_cells.find(m_itemCell[item]);
+    if (it == m_cells.end()) {
+        return;
+    }
+    
+    // Swap-remove keeps removal O(1); the moved item's slot is patched up
+    QVector<int> &cell = it.value();
+    int slot = m_itemSlot[item];
+    int last = cell.last();
+    cell[slot] = last;
+    m_itemSlot[last] = slot;
+    cell.removeLast();
+    
+    if (cell.isEmpty()) {
+        m_cells.erase(it);
+    }
+}
@@ -0,0 +1,167 @@
+#include "core/WorkStealingThreadPool.h"
+
+static thread_local const WorkStealingThreadPool *t_currentPool = nullptr;
+static thread_local int t_workerIndex = -1;
+
+WorkStealingThreadPool::WorkStealingThreadPool(int threadCount)
+    : m_pending(0)
+    , m_nextQueue(0)
+    , m_stopping(false)
+{
+    threadCount = threadCount > 0 ? threadCount : 0;
+    
+    for (int i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkStealingThreadPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    
+    // Workers drain whatever is still queued before they exit
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingThreadPool::submit(std::function<void()> task)
+{
+    if (m_threads.empty()) {
+        task();
+        return;
+    }
+    
+    int self = currentWorkerIndex();
+    int queue = self >= 0 ? self : int(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+    push(queue, std::move(task));
+    wakeWorkers(1);
+}
+
+void WorkStealingThreadPool::parallelFor(int count, const std::function<void(int)> &body)
+{
+    if (count <= 0) {
+        return;
+    }
+    
+    if (m_threads.empty()) {
+        for (int i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+    
+    std::atomic<int> remaining(count);
+    int self = currentWorkerIndex();
+    unsigned start = m_nextQueue.fetch_add(1, std::memory_order_relaxed);
+    
+    // A worker keeps its own range local and lets idle siblings steal it;
+    // an outside caller spreads the range across all deques up front.
+    for (int i = 0; i < count; ++i) {
+        int queue = self >= 0 ? self : int((start + i) % m_queues.size());
+        push(queue, [&body, &remaining, i]() {
+            body(i);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    wakeWorkers(count);
+    
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runPendingTask(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+int WorkStealingThreadPool::currentWorkerIndex() const
+{
+    return t_currentPool == this ? t_workerIndex : -1;
+}
+
+void WorkStealingThreadPool::push(int queueIndex, Task task)
+{
+    WorkerQueue &queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+}
+
+void WorkStealingThreadPool::wakeWorkers(int taskCount)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_pending.fetch_add(taskCount, std::memory_order_relaxed);
+    }
+    m_wake.notify_all();
+}
+
+bool WorkStealingThreadPool::popLocal(int index, Task &task)
+{
+    WorkerQueue &queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingThreadPool::steal(int thief, Task &task)
+{
+    int queueCount = int(m_queues.size());
+    int first = thief >= 0 ? thief + 1 : int(m_nextQueue.load(std::memory_order_relaxed));
+    
+    for (int offset = 0; offset < queueCount; ++offset) {
+        int victim = (first + offset) % queueCount;
+        if (victim == thief) {
+            continue;
+        }
+        
+        WorkerQueue &queue = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::runPendingTask(int self)
+{
+    Task task;
+    if ((self >= 0 && popLocal(self, task)) || steal(self, task)) {
+        m_pending.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::workerLoop(int index)
+{
+    t_currentPool = this;
+    t_workerIndex = index;
+    
+    for (;;) {
+        if (runPendingTask(index)) {
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this]() {
+            return m_stopping || m_pending.load(std::memory_order_relaxed) > 0;
+        });
+        if (m_stopping && m_pending.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
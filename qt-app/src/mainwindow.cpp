@@ -23,6 +23,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_gameView(nullptr)
     , m_controlPanel(nullptr)
     , m_gameEngine(nullptr)
+    , m_engineThread(nullptr)
     , m_startAction(nullptr)
     , m_stopAction(nullptr)
     , m_pauseAction(nullptr)
@@ -51,6 +52,11 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // The engine is deleted on its own thread once the loop has finished
+    if (m_engineThread) {
+        m_engineThread->quit();
+        m_engineThread->wait();
+    }
 }
 
 void MainWindow::createMenuBar()
@@ -99,8 +105,8 @@ void MainWindow::createMenuBar()
             m_gameEngine->stopGame();
            
             if (m_gameEngine->vehicle()) {
-                m_gameEngine->vehicle()->setPosition(QPointF(100, 300));
-                m_gameEngine->vehicle()->setSpeed(0.0);
+                m_gameEngine->requestVehiclePosition(QPointF(100, 300));
+                m_gameEngine->requestVehicleSpeed(0.0);
             }
             statusBar()->showMessage("Simulation reset");
         }
@@ -185,7 +191,22 @@ void MainWindow::createCentralWidget()
 
 void MainWindow::setupGameEngine()
 {
-    m_gameEngine = new GameEngine(this);
+    // Physics, its timer and the reporting socket all run on a dedicated
+    // thread; the views only read the snapshots the engine publishes, so a
+    // slow repaint never holds up a physics step.
+    m_gameEngine = new GameEngine();
+    m_gameEngine->setFleetReportingEnabled(true);
+    m_engineThread = new QThread(this);
+    m_engineThread->setObjectName("GameEngine");
+    m_gameEngine->moveToThread(m_engineThread);
+    connect(m_engineThread, &QThread::finished, m_gameEngine, &QObject::deleteLater);
+    m_engineThread->start();
+    
+    SpeedReportingService *reportingService = m_gameEngine->speedReportingService();
+    QMetaObject::invokeMethod(reportingService, [reportingService]() {
+        reportingService->startReporting();
+    }, Qt::QueuedConnection);
+    
     if (m_gameView) {
         m_gameView->setGameEngine(m_gameEngine);
     }
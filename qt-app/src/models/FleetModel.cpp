@@ -0,0 +1,278 @@
+#include "models/FleetModel.h"
+#include "core/WorkStealingThreadPool.h"
+#include <QRandomGenerator>
+#include <algorithm>
+
+// A multiple of every SIMD width so chunk tails never change kernel results
+const int FleetModel::CHUNK_SIZE = 16384;
+
+FleetModel::FleetModel(QObject *parent)
+    : QObject(parent)
+    , m_threadPool(nullptr)
+    , m_stepInFlight(false)
+    , m_stepFinished(false)
+    , m_positionVersion(0)
+    , m_seed(1)
+    , m_roadBounds(0, 250, 2000, 100)
+    , m_laneCount(3)
+    , m_vehicleSize(60, 30)
+    , m_averageSpeed(0.0)
+    , m_topSpeed(0.0)
+    , m_dirty(false)
+{
+}
+
+FleetModel::~FleetModel()
+{
+    waitForSteps();
+}
+
+void FleetModel::resize(int count)
+{
+    count = qMax(0, count);
+    if (count == vehicleCount()) {
+        return;
+    }
+    
+    waitForSteps();
+    
+    m_positionX.resize(count);
+    m_positionY.resize(count);
+    m_speed.resize(count);
+    m_acceleration.resize(count);
+    m_maxSpeed.resize(count);
+    m_backPositionX.resize(count);
+    m_backSpeed.resize(count);
+    m_chunkResults.resize(chunkCount());
+    
+    spawnVehicles();
+    
+    m_dirty = true;
+    emit fleetResized(count);
+}
+
+void FleetModel::clear()
+{
+    resize(0);
+}
+
+void FleetModel::setRoadBounds(const QRectF &bounds)
+{
+    waitForSteps();
+    m_roadBounds = bounds;
+    spawnVehicles();
+}
+
+void FleetModel::setLaneCount(int lanes)
+{
+    waitForSteps();
+    m_laneCount = qMax(1, lanes);
+    spawnVehicles();
+}
+
+void FleetModel::setSpeed(int index, double speed)
+{
+    waitForSteps();
+    if (index >= 0 && index < vehicleCount()) {
+        m_speed[index] = qBound(0.0, speed, m_maxSpeed[index]);
+        m_dirty = true;
+    }
+}
+
+void FleetModel::setAcceleration(int index, double acceleration)
+{
+    waitForSteps();
+    if (index >= 0 && index < vehicleCount()) {
+        m_acceleration[index] = acceleration;
+        m_dirty = true;
+    }
+}
+
+void FleetModel::setThreadPool(WorkStealingThreadPool *pool)
+{
+    waitForSteps();
+    m_threadPool = pool;
+}
+
+void FleetModel::updatePhysics(double deltaTime, double frictionFactor)
+{
+    // One step, simulated in place and visible as soon as this returns
+    waitForSteps();
+    
+    int count = vehicleCount();
+    if (count == 0) {
+        return;
+    }
+    
+    double *positions = m_positionX.data();
+    double *speeds = m_speed.data();
+    const double *accelerations = m_acceleration.constData();
+    const double *limits = m_maxSpeed.constData();
+    FleetKernels::Result *results = m_chunkResults.data();
+    FleetKernels::Params params = { deltaTime, frictionFactor,
+                                    m_roadBounds.left(), m_roadBounds.width() };
+    
+    auto runChunk = [=](int chunk) {
+        int first = chunk * CHUNK_SIZE;
+        FleetKernels::Batch batch = { positions + first, speeds + first, accelerations + first,
+                                      limits + first, qMin(CHUNK_SIZE, count - first) };
+        results[chunk] = FleetKernels::integrate(batch, params);
+    };
+    
+    if (m_threadPool) {
+        m_threadPool->parallelFor(chunkCount(), runChunk);
+    } else {
+        for (int chunk = 0; chunk < chunkCount(); ++chunk) {
+            runChunk(chunk);
+        }
+    }
+    
+    finishSteps();
+}
+
+void FleetModel::beginSteps(int steps, double deltaTime, double frictionFactor)
+{
+    waitForSteps();
+    
+    int count = vehicleCount();
+    if (count == 0 || steps <= 0) {
+        return;
+    }
+    
+    // Same order as the single vehicle: move, then accelerate, apply
+    // friction and clamp to [0, maxSpeed]. The track wraps around. Each
+    // chunk copies its slice of the published state into the back buffer
+    // and runs every step on it while the slice is still in cache.
+    const double *frontPositions = m_positionX.constData();
+    const double *frontSpeeds = m_speed.constData();
+    double *positions = m_backPositionX.data();
+    double *speeds = m_backSpeed.data();
+    const double *accelerations = m_acceleration.constData();
+    const double *limits = m_maxSpeed.constData();
+    FleetKernels::Result *results = m_chunkResults.data();
+    FleetKernels::Params params = { deltaTime, frictionFactor,
+                                    m_roadBounds.left(), m_roadBounds.width() };
+    int chunks = chunkCount();
+    
+    auto runChunk = [=](int chunk) {
+        int first = chunk * CHUNK_SIZE;
+        int size = qMin(CHUNK_SIZE, count - first);
+        std::copy(frontPositions + first, frontPositions + first + size, positions + first);
+        std::copy(frontSpeeds + first, frontSpeeds + first + size, speeds + first);
+        
+        FleetKernels::Batch batch = { positions + first, speeds + first, accelerations + first,
+                                      limits + first, size };
+        for (int step = 0; step < steps; ++step) {
+            results[chunk] = FleetKernels::integrate(batch, params);
+        }
+    };
+    
+    m_stepInFlight = true;
+    m_stepFinished = false;
+    
+    if (!m_threadPool) {
+        for (int chunk = 0; chunk < chunks; ++chunk) {
+            runChunk(chunk);
+        }
+        m_stepFinished = true;
+        return;
+    }
+    
+    WorkStealingThreadPool *pool = m_threadPool;
+    pool->submit([this, pool, chunks, runChunk]() {
+        pool->parallelFor(chunks, runChunk);
+        {
+            std::lock_guard<std::mutex> lock(m_stepMutex);
+            m_stepFinished = true;
+        }
+        m_stepDone.notify_all();
+    });
+}
+
+bool FleetModel::collectSteps()
+{
+    if (!m_stepInFlight) {
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_stepMutex);
+        if (!m_stepFinished) {
+            return false;
+        }
+    }
+    
+    m_positionX.swap(m_backPositionX);
+    m_speed.swap(m_backSpeed);
+    finishSteps();
+    return true;
+}
+
+void FleetModel::waitForSteps()
+{
+    if (!m_stepInFlight) {
+        return;
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(m_stepMutex);
+        m_stepDone.wait(lock, [this]() { return m_stepFinished; });
+    }
+    
+    collectSteps();
+}
+
+int FleetModel::chunkCount() const
+{
+    return (vehicleCount() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+void FleetModel::finishSteps()
+{
+    // Combine per-chunk aggregates in chunk order, never completion order
+    double speedSum = 0.0;
+    double topSpeed = 0.0;
+    for (const FleetKernels::Result &result : m_chunkResults) {
+        speedSum += result.speedSum;
+        topSpeed = qMax(topSpeed, result.topSpeed);
+    }
+    
+    int count = vehicleCount();
+    m_averageSpeed = count > 0 ? speedSum / count : 0.0;
+    m_topSpeed = topSpeed;
+    m_stepInFlight = false;
+    m_dirty = true;
+    ++m_positionVersion;
+}
+
+void FleetModel::publishChanges()
+{
+    if (m_dirty) {
+        m_dirty = false;
+        emit fleetUpdated(vehicleCount(), m_averageSpeed, m_topSpeed);
+    }
+}
+
+void FleetModel::spawnVehicles()
+{
+    // Every slot is seeded from its index, so a given seed and fleet size
+    // always produce the same starting fleet.
+    int count = vehicleCount();
+    double laneHeight = m_roadBounds.height() / m_laneCount;
+    int perLane = qMax(1, (count + m_laneCount - 1) / m_laneCount);
+    double spacing = m_roadBounds.width() / perLane;
+    
+    for (int i = 0; i < count; ++i) {
+        QRandomGenerator generator(m_seed ^ (quint32(i) * 2654435761u));
+        int lane = i % m_laneCount;
+        int slot = i / m_laneCount;
+        
+        m_positionX[i] = m_roadBounds.left() + slot * spacing;
+        m_positionY[i] = m_roadBounds.top() + laneHeight * (lane + 0.5);
+        m_maxSpeed[i] = 80.0 + generator.bounded(120.0);
+        m_speed[i] = generator.bounded(m_maxSpeed[i]);
+        m_acceleration[i] = 20.0 + generator.bounded(40.0);
+    }
+    
+    ++m_positionVersion;
+}
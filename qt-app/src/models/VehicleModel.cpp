@@ -12,13 +12,14 @@ VehicleModel::VehicleModel(QObject *parent)
     , m_size(60, 30)
     , m_currentFrame(0)
     , m_isMoving(false)
+    , m_spritesLoaded(false)
+    , m_pendingChanges(0)
 {
     m_animationTimer = new QTimer(this);
     m_animationTimer->setInterval(100); 
     connect(m_animationTimer, &QTimer::timeout, this, &VehicleModel::updateAnimation);
     
     initializeVehicle();
-    loadSprites();
 }
 
 VehicleModel::~VehicleModel()
@@ -34,7 +35,7 @@ void VehicleModel::setPosition(const QPointF &pos)
 {
     if (m_position != pos) {
         m_position = pos;
-        emit positionChanged(m_position);
+        m_pendingChanges |= PositionChange;
     }
 }
 
@@ -48,6 +49,19 @@ void VehicleModel::setSpeed(double newSpeed)
     newSpeed = qBound(0.0, newSpeed, m_maxSpeed);
     if (qAbs(m_speed - newSpeed) > 0.1) {
         m_speed = newSpeed;
+        m_pendingChanges |= SpeedChange;
+    }
+}
+
+void VehicleModel::publishChanges()
+{
+    quint32 changes = m_pendingChanges;
+    m_pendingChanges = 0;
+    
+    if (changes & PositionChange) {
+        emit positionChanged(m_position);
+    }
+    if (changes & SpeedChange) {
         emit speedChanged(m_speed);
     }
 }
@@ -106,6 +120,11 @@ bool VehicleModel::isOnRoad(const QRectF &roadBounds) const
 
 QPixmap VehicleModel::currentSprite() const
 {
+    // Sprites are built on first use so headless runs never touch QPixmap
+    if (!m_spritesLoaded) {
+        const_cast<VehicleModel *>(this)->loadSprites();
+    }
+    
     if (m_sprites.isEmpty()) {
         QPixmap defaultSprite(m_size.toSize());
         defaultSprite.fill(Qt::transparent);
@@ -135,6 +154,7 @@ QPixmap VehicleModel::currentSprite() const
 void VehicleModel::loadSprites()
 {
     m_sprites.clear();
+    m_spritesLoaded = true;
     
     
     QString spritePath = ":/assets/vehicles/";
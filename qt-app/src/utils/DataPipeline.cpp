@@ -0,0 +1,199 @@
+#include "utils/DataPipeline.h"
+#include "core/WorkStealingThreadPool.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <mutex>
+
+// Large enough that per-chunk task overhead vanishes, small enough that a
+// chunk stays in L2 between stages
+const int DataPipeline::DEFAULT_CHUNK_SIZE = 16384;
+
+// A few chunks per worker keeps every stage busy without queueing the
+// whole input on the pool
+const int DataPipeline::DEFAULT_MAX_CHUNKS_IN_FLIGHT = 32;
+
+DataPipeline::DataPipeline(WorkStealingThreadPool *pool)
+    : m_pool(pool)
+    , m_chunkSize(DEFAULT_CHUNK_SIZE)
+    , m_maxChunksInFlight(DEFAULT_MAX_CHUNKS_IN_FLIGHT)
+    , m_validMin(-std::numeric_limits<double>::infinity())
+    , m_validMax(std::numeric_limits<double>::infinity())
+{
+    resetCounters();
+}
+
+void DataPipeline::setPool(WorkStealingThreadPool *pool)
+{
+    m_pool = pool;
+}
+
+void DataPipeline::setChunkSize(int samples)
+{
+    m_chunkSize = qMax(1, samples);
+}
+
+void DataPipeline::setMaxChunksInFlight(int chunks)
+{
+    m_maxChunksInFlight = qMax(1, chunks);
+}
+
+void DataPipeline::setValidRange(double minValue, double maxValue)
+{
+    m_validMin = minValue;
+    m_validMax = maxValue;
+}
+
+DataPipeline::Result DataPipeline::run(const double *data, qint64 count,
+                                       const std::vector<std::unique_ptr<StreamingFilter>> &filters)
+{
+    QElapsedTimer clock;
+    clock.start();
+    
+    Result result = {};
+    qint64 chunkCount = (qMax<qint64>(0, count) + m_chunkSize - 1) / m_chunkSize;
+    std::vector<QVector<double>> outputs(chunkCount);
+    std::vector<StatsKernels::Moments> moments(chunkCount);
+    std::atomic<qint64> rejected(0);
+    
+    // Everything below is guarded by mutex. Tasks notify while holding it,
+    // so this frame cannot return while one is still touching its locals.
+    std::mutex mutex;
+    std::condition_variable changed;
+    int inFlight = 0;
+    qint64 completed = 0;
+    std::map<qint64, QVector<double>> validated;
+    qint64 nextToFilter = 0;
+    bool filtering = false;
+    
+    auto statistics = [&](qint64 index) {
+        QElapsedTimer timer;
+        timer.start();
+        moments[index] = StatsKernels::moments(outputs[index].constData(), outputs[index].size());
+        record(Statistics, outputs[index].size(), timer.nsecsElapsed());
+    
+        std::lock_guard<std::mutex> lock(mutex);
+        --inFlight;
+        ++completed;
+        changed.notify_all();
+    };
+    
+    // The pool is never called into with the mutex held: a pool without
+    // threads runs tasks inline
+    auto filterInOrder = [&](qint64 index, QVector<double> chunk) {
+        std::unique_lock<std::mutex> lock(mutex);
+        validated.emplace(index, std::move(chunk));
+        if (filtering) {
+            return;
+        }
+    
+        filtering = true;
+        for (auto next = validated.find(nextToFilter); next != validated.end(); next = validated.find(nextToFilter)) {
+            qint64 current = nextToFilter++;
+            QVector<double> values = std::move(next->second);
+            validated.erase(next);
+            lock.unlock();
+    
+            QElapsedTimer timer;
+            timer.start();
+            for (double &value : values) {
+                for (const auto &filter : filters) {
+                    value = filter->push(value);
+                }
+            }
+            record(Filter, values.size(), timer.nsecsElapsed());
+            outputs[current] = std::move(values);
+            m_pool->submit([&, current]() { statistics(current); });
+    
+            lock.lock();
+        }
+        filtering = false;
+        changed.notify_all();
+    };
+    
+    for (qint64 index = 0; index < chunkCount; ++index) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (inFlight >= m_maxChunksInFlight) {
+                QElapsedTimer stall;
+                stall.start();
+                changed.wait(lock, [&]() { return inFlight < m_maxChunksInFlight; });
+                m_counters[Ingest].stallNanos += stall.nsecsElapsed();
+            }
+            ++inFlight;
+        }
+    
+        QElapsedTimer timer;
+        timer.start();
+        qint64 first = index * m_chunkSize;
+        int size = int(qMin<qint64>(m_chunkSize, count - first));
+        QVector<double> chunk(size);
+        std::copy(data + first, data + first + size, chunk.begin());
+        record(Ingest, size, timer.nsecsElapsed());
+    
+        m_pool->submit([&, index, chunk = std::move(chunk)]() mutable {
+            // Same rule as DataProcessor::validateDataPoints()
+            QElapsedTimer timer;
+            timer.start();
+            int received = int(chunk.size());
+            auto end = std::remove_if(chunk.begin(), chunk.end(), [this](double value) {
+                return !(std::isfinite(value) && value >= m_validMin && value <= m_validMax);
+            });
+            chunk.erase(end, chunk.end());
+            rejected += received - chunk.size();
+            record(Validate, received, timer.nsecsElapsed());
+    
+            filterInOrder(index, std::move(chunk));
+        });
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return completed == chunkCount && !filtering; });
+    }
+    
+    qint64 accepted = 0;
+    for (const QVector<double> &output : outputs) {
+        accepted += output.size();
+    }
+    result.filtered.reserve(accepted);
+    for (qint64 index = 0; index < chunkCount; ++index) {
+        result.filtered += outputs[index];
+        result.moments = StatsKernels::combine(result.moments, moments[index]);
+    }
+    result.rejected = rejected;
+    result.elapsedNanos = clock.nsecsElapsed();
+    return result;
+}
+
+DataPipeline::StageCounters DataPipeline::counters(Stage stage) const
+{
+    const AtomicCounters &counters = m_counters[stage];
+    StageCounters snapshot;
+    snapshot.chunks = counters.chunks.load(std::memory_order_relaxed);
+    snapshot.samples = counters.samples.load(std::memory_order_relaxed);
+    snapshot.busyNanos = counters.busyNanos.load(std::memory_order_relaxed);
+    snapshot.stallNanos = counters.stallNanos.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void DataPipeline::resetCounters()
+{
+    for (AtomicCounters &counters : m_counters) {
+        counters.chunks = 0;
+        counters.samples = 0;
+        counters.busyNanos = 0;
+        counters.stallNanos = 0;
+    }
+}
+
+void DataPipeline::record(Stage stage, qint64 samples, qint64 nanos)
+{
+    AtomicCounters &counters = m_counters[stage];
+    counters.chunks.fetch_add(1, std::memory_order_relaxed);
+    counters.samples.fetch_add(quint64(samples), std::memory_order_relaxed);
+    counters.busyNanos.fetch_add(nanos, std::memory_order_relaxed);
+}
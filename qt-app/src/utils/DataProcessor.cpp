@@ -0,0 +1,831 @@
+#include "utils/DataProcessor.h"
+#include "core/WorkStealingThreadPool.h"
+#include "utils/CsvColumnReader.h"
+#include "utils/OrderStatistics.h"
+#include "utils/StatsKernels.h"
+#include <QFile>
+#include <QTextStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const QString DataProcessor::DEFAULT_PROCESSING_MODE = "batch";
+const QString DataProcessor::PARALLEL_PROCESSING_MODE = "parallel";
+const int DataProcessor::DEFAULT_BATCH_SIZE = 100;
+const int DataProcessor::DEFAULT_PROCESSING_INTERVAL = 1000;
+const int DataProcessor::REAL_TIME_BUFFER_SIZE = 1000;
+const int DataProcessor::REAL_TIME_PROCESSING_INTERVAL = 100;
+
+DataProcessor::DataProcessor(QObject* parent)
+    : QObject(parent)
+    , m_streamingFiltersDirty(true)
+    , m_processingMode(DEFAULT_PROCESSING_MODE)
+    , m_batchSize(DEFAULT_BATCH_SIZE)
+    , m_processingInterval(DEFAULT_PROCESSING_INTERVAL)
+    , m_autoProcessing(false)
+    , m_realTimeProcessing(false)
+    , m_processingTimer(nullptr)
+    , m_realTimeTimer(nullptr)
+    , m_currentStatistics()
+    , m_totalProcessedPoints(0)
+    , m_processingThread(nullptr)
+    , m_isProcessing(false)
+    , m_pipeline(nullptr)
+    , m_pipelineThreads(qMax(1, QThread::idealThreadCount() - 1))
+    , m_validMin(-std::numeric_limits<double>::infinity())
+    , m_validMax(std::numeric_limits<double>::infinity())
+{
+    m_processingTimer = new QTimer(this);
+    m_processingTimer->setInterval(m_processingInterval);
+    connect(m_processingTimer, &QTimer::timeout, this, &DataProcessor::onProcessingTimer);
+    
+    m_realTimeTimer = new QTimer(this);
+    m_realTimeTimer->setInterval(REAL_TIME_PROCESSING_INTERVAL);
+    connect(m_realTimeTimer, &QTimer::timeout, this, &DataProcessor::onRealTimeProcessing);
+}
+
+DataProcessor::~DataProcessor()
+{
+    stopRealTimeProcessing();
+}
+
+QVector<double> DataProcessor::filterData(const QVector<double>& data, const QString& filterType, double parameter)
+{
+    QVector<double> result;
+    
+    if (filterType == "moving_average") {
+        result = applyMovingAverageFilter(data, parameter > 0 ? int(parameter) : 5);
+    } else if (filterType == "median") {
+        result = applyMedianFilter(data, parameter > 0 ? int(parameter) : 5);
+    } else if (filterType == "gaussian") {
+        result = applyGaussianFilter(data, parameter > 0 ? parameter : 1.0);
+    } else if (filterType == "kalman") {
+        result = applyKalmanFilter(data, parameter > 0 ? parameter : 0.01, 1.0);
+    } else {
+        emit errorOccurred(QString("Unknown filter type: %1").arg(filterType));
+        return data;
+    }
+    
+    emit filterApplied(filterType, result);
+    return result;
+}
+
+QVector<double> DataProcessor::smoothData(const QVector<double>& data, int windowSize)
+{
+    return applyMovingAverageFilter(data, windowSize);
+}
+
+QVector<double> DataProcessor::normalizeData(const QVector<double>& data)
+{
+    if (data.isEmpty()) {
+        return data;
+    }
+    
+    double minValue = *std::min_element(data.begin(), data.end());
+    double maxValue = *std::max_element(data.begin(), data.end());
+    double range = maxValue - minValue;
+    
+    QVector<double> result(data.size(), 0.0);
+    if (range > 0.0) {
+        for (int i = 0; i < data.size(); ++i) {
+            result[i] = (data[i] - minValue) / range;
+        }
+    }
+    return result;
+}
+
+QVector<double> DataProcessor::removeOutliers(const QVector<double>& data, double threshold)
+{
+    QVector<double> result;
+    for (double value : data) {
+        if (!isOutlier(value, data, threshold)) {
+            result.append(value);
+        }
+    }
+    return result;
+}
+
+QVector<double> DataProcessor::interpolateData(const QVector<double>& data, int targetSize)
+{
+    if (data.size() < 2 || targetSize < 2) {
+        return data;
+    }
+    
+    // Linear resampling onto targetSize evenly spaced points
+    QVector<double> result(targetSize);
+    double scale = double(data.size() - 1) / (targetSize - 1);
+    for (int i = 0; i < targetSize; ++i) {
+        double position = i * scale;
+        int index = qMin(int(position), int(data.size()) - 2);
+        double fraction = position - index;
+        result[i] = data[index] + (data[index + 1] - data[index]) * fraction;
+    }
+    return result;
+}
+
+DataStatistics DataProcessor::calculateStatistics(const QVector<double>& data)
+{
+    DataStatistics stats = {};
+    stats.dataPoints = data.size();
+    
+    if (data.isEmpty()) {
+        return stats;
+    }
+    
+    // One pass for everything but the median
+    StatsKernels::Moments moments = StatsKernels::moments(data.constData(), data.size());
+    stats.mean = StatsKernels::mean(moments);
+    stats.median = calculateMedian(data);
+    stats.variance = StatsKernels::variance(moments);
+    stats.standardDeviation = std::sqrt(stats.variance);
+    stats.minValue = moments.minValue;
+    stats.maxValue = moments.maxValue;
+    stats.range = stats.maxValue - stats.minValue;
+    stats.totalSum = StatsKernels::rawSum(moments);
+    stats.totalSquaredSum = StatsKernels::rawSumSquares(moments);
+    
+    emit statisticsCalculated(stats);
+    return stats;
+}
+
+DataStatistics DataProcessor::calculateStatistics(const QVector<double>& data, const QDateTime& start, const QDateTime& end)
+{
+    DataStatistics stats = calculateStatistics(data);
+    stats.startTime = start;
+    stats.endTime = end;
+    return stats;
+}
+
+double DataProcessor::calculateMean(const QVector<double>& data)
+{
+    return StatsKernels::mean(StatsKernels::moments(data.constData(), data.size()));
+}
+
+double DataProcessor::calculateMedian(const QVector<double>& data)
+{
+    return calculatePercentile(data, 50.0);
+}
+
+QVector<double> DataProcessor::calculatePercentiles(const QVector<double>& data, const QVector<double>& percentiles)
+{
+    return OrderStatistics::percentiles(data, percentiles);
+}
+
+double DataProcessor::calculateStandardDeviation(const QVector<double>& data)
+{
+    return std::sqrt(calculateVariance(data));
+}
+
+double DataProcessor::calculateVariance(const QVector<double>& data)
+{
+    return StatsKernels::variance(StatsKernels::moments(data.constData(), data.size()));
+}
+
+double DataProcessor::calculateCorrelation(const QVector<double>& data1, const QVector<double>& data2)
+{
+    qint64 count = qMin(data1.size(), data2.size());
+    return StatsKernels::correlation(StatsKernels::crossMoments(data1.constData(), data2.constData(), count));
+}
+
+bool DataProcessor::isValidData(const QVector<double>& data)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+    
+    for (double value : data) {
+        if (!std::isfinite(value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QVector<bool> DataProcessor::validateDataPoints(const QVector<double>& data, double minValue, double maxValue)
+{
+    QVector<bool> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = std::isfinite(data[i]) && data[i] >= minValue && data[i] <= maxValue;
+    }
+    return result;
+}
+
+QString DataProcessor::validateDataRange(const QVector<double>& data, double minValue, double maxValue)
+{
+    QVector<bool> valid = validateDataPoints(data, minValue, maxValue);
+    int invalidCount = int(std::count(valid.begin(), valid.end(), false));
+    
+    if (invalidCount == 0) {
+        return QString("All %1 data points within [%2, %3]").arg(data.size()).arg(minValue).arg(maxValue);
+    }
+    return QString("%1 of %2 data points outside [%3, %4]").arg(invalidCount).arg(data.size()).arg(minValue).arg(maxValue);
+}
+
+QVector<double> DataProcessor::convertUnits(const QVector<double>& data, const QString& fromUnit, const QString& toUnit)
+{
+    static const QStringList speedUnits = { "km/h", "m/s", "mph", "knots" };
+    static const QStringList distanceUnits = { "m", "km", "mi", "ft" };
+    
+    QVector<double> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        if (speedUnits.contains(fromUnit)) {
+            result[i] = convertSpeed(data[i], fromUnit, toUnit);
+        } else if (distanceUnits.contains(fromUnit)) {
+            result[i] = convertDistance(data[i], fromUnit, toUnit);
+        } else {
+            result[i] = convertTime(data[i], fromUnit, toUnit);
+        }
+    }
+    return result;
+}
+
+double DataProcessor::convertSpeed(double speed, const QString& fromUnit, const QString& toUnit)
+{
+    // Everything goes through m/s
+    auto toMetersPerSecond = [](const QString& unit) {
+        if (unit == "km/h") return 1.0 / 3.6;
+        if (unit == "mph") return 0.44704;
+        if (unit == "knots") return 0.514444;
+        return 1.0;
+    };
+    return speed * toMetersPerSecond(fromUnit) / toMetersPerSecond(toUnit);
+}
+
+double DataProcessor::convertDistance(double distance, const QString& fromUnit, const QString& toUnit)
+{
+    auto toMeters = [](const QString& unit) {
+        if (unit == "km") return 1000.0;
+        if (unit == "mi") return 1609.344;
+        if (unit == "ft") return 0.3048;
+        return 1.0;
+    };
+    return distance * toMeters(fromUnit) / toMeters(toUnit);
+}
+
+double DataProcessor::convertTime(double time, const QString& fromUnit, const QString& toUnit)
+{
+    auto toSeconds = [](const QString& unit) {
+        if (unit == "ms") return 0.001;
+        if (unit == "min") return 60.0;
+        if (unit == "h") return 3600.0;
+        return 1.0;
+    };
+    return time * toSeconds(fromUnit) / toSeconds(toUnit);
+}
+
+bool DataProcessor::exportToCsv(const QVector<double>& data, const QString& filePath, const QStringList& headers)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        emit errorOccurred(QString("Cannot write %1: %2").arg(filePath, file.errorString()));
+        return false;
+    }
+    
+    QTextStream out(&file);
+    out << (headers.isEmpty() ? QString("value") : headers.join(",")) << "\n";
+    for (double value : data) {
+        out << value << "\n";
+    }
+    return true;
+}
+
+bool DataProcessor::exportToJson(const QVector<double>& data, const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit errorOccurred(QString("Cannot write %1: %2").arg(filePath, file.errorString()));
+        return false;
+    }
+    
+    QJsonArray values;
+    for (double value : data) {
+        values.append(value);
+    }
+    
+    QJsonObject root;
+    root["count"] = data.size();
+    root["exported"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["data"] = values;
+    
+    file.write(QJsonDocument(root).toJson());
+    return true;
+}
+
+QVector<double> DataProcessor::importFromCsv(const QString& filePath, int columnIndex)
+{
+    CsvColumnReader reader;
+    if (!reader.open(filePath)) {
+        emit errorOccurred(QString("Cannot read %1: %2").arg(filePath, reader.errorString()));
+        return QVector<double>();
+    }
+    
+    // Header and malformed rows are skipped; big files are parsed in
+    // parallel on the pipeline's pool
+    QMutexLocker locker(&m_processingMutex);
+    return reader.readColumn(columnIndex, pipelinePool());
+}
+
+QVector<double> DataProcessor::importFromJson(const QString& filePath)
+{
+    QVector<double> result;
+    
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit errorOccurred(QString("Cannot read %1: %2").arg(filePath, file.errorString()));
+        return result;
+    }
+    
+    // Parsed straight from the mapping when the file can be mapped
+    QByteArray contents;
+    if (uchar *mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr) {
+        contents = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file.size());
+    } else {
+        contents = file.readAll();
+    }
+    
+    QJsonDocument doc = QJsonDocument::fromJson(contents);
+    QJsonArray values = doc.isArray() ? doc.array() : doc.object().value("data").toArray();
+    result.reserve(values.size());
+    for (const QJsonValue &value : values) {
+        if (value.isDouble()) {
+            result.append(value.toDouble());
+        }
+    }
+    return result;
+}
+
+void DataProcessor::startRealTimeProcessing()
+{
+    if (!m_realTimeProcessing) {
+        m_realTimeProcessing = true;
+        m_processingStartTime = QDateTime::currentDateTime();
+        {
+            QMutexLocker locker(&m_dataMutex);
+            m_realTimeQuantiles.clear();
+        }
+        m_realTimeTimer->start();
+        if (m_autoProcessing) {
+            m_processingTimer->start();
+        }
+        emit processingStarted();
+    }
+}
+
+void DataProcessor::stopRealTimeProcessing()
+{
+    if (m_realTimeProcessing) {
+        m_realTimeProcessing = false;
+        m_realTimeTimer->stop();
+        m_processingTimer->stop();
+        processRealTimeData();
+        emit processingFinished();
+    }
+}
+
+bool DataProcessor::isRealTimeProcessing() const
+{
+    return m_realTimeProcessing;
+}
+
+void DataProcessor::addRealTimeData(double value, const QDateTime& timestamp)
+{
+    addToRealTimeBuffer(value, timestamp);
+}
+
+QVector<ProcessedData> DataProcessor::getProcessedData() const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_processedData;
+}
+
+double DataProcessor::getRealTimePercentile(double percentile) const
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_realTimeQuantiles.percentile(percentile);
+}
+
+void DataProcessor::addFilter(const DataFilter& filter)
+{
+    removeFilter(filter.name);
+    m_filters.append(filter);
+    m_streamingFiltersDirty = true;
+}
+
+void DataProcessor::removeFilter(const QString& filterName)
+{
+    for (int i = m_filters.size() - 1; i >= 0; --i) {
+        if (m_filters[i].name == filterName) {
+            m_filters.removeAt(i);
+            m_streamingFiltersDirty = true;
+        }
+    }
+}
+
+void DataProcessor::enableFilter(const QString& filterName, bool enable)
+{
+    for (DataFilter &filter : m_filters) {
+        if (filter.name == filterName && filter.isEnabled != enable) {
+            filter.isEnabled = enable;
+            m_streamingFiltersDirty = true;
+        }
+    }
+}
+
+QVector<DataFilter> DataProcessor::getFilters() const
+{
+    return m_filters;
+}
+
+void DataProcessor::clearFilters()
+{
+    m_filters.clear();
+    m_streamingFiltersDirty = true;
+}
+
+void DataProcessor::setProcessingMode(const QString& mode)
+{
+    m_processingMode = mode;
+}
+
+QString DataProcessor::getProcessingMode() const
+{
+    return m_processingMode;
+}
+
+void DataProcessor::setBatchSize(int size)
+{
+    m_batchSize = qMax(1, size);
+}
+
+int DataProcessor::getBatchSize() const
+{
+    return m_batchSize;
+}
+
+void DataProcessor::setProcessingInterval(int interval)
+{
+    m_processingInterval = qMax(1, interval);
+    m_processingTimer->setInterval(m_processingInterval);
+}
+
+int DataProcessor::getProcessingInterval() const
+{
+    return m_processingInterval;
+}
+
+void DataProcessor::setAutoProcessing(bool autoProcess)
+{
+    m_autoProcessing = autoProcess;
+    if (m_autoProcessing && m_realTimeProcessing) {
+        m_processingTimer->start();
+    } else {
+        m_processingTimer->stop();
+    }
+}
+
+bool DataProcessor::isAutoProcessing() const
+{
+    return m_autoProcessing;
+}
+
+QVector<double> DataProcessor::runPipeline(const QVector<double>& data)
+{
+    QMutexLocker locker(&m_processingMutex);
+    m_isProcessing = true;
+    
+    m_pipeline.setPool(pipelinePool());
+    m_pipeline.setValidRange(m_validMin, m_validMax);
+    
+    // A fresh chain each run, so each batch is filtered afresh
+    std::vector<std::unique_ptr<StreamingFilter>> filters = createStreamingFilters();
+    DataPipeline::Result result = m_pipeline.run(data.constData(), data.size(), filters);
+    finishBatch(result.filtered, result.moments);
+    
+    m_isProcessing = false;
+    return result.filtered;
+}
+
+void DataProcessor::finishBatch(const QVector<double>& filtered, const StatsKernels::Moments& moments)
+{
+    DataStatistics stats = {};
+    stats.dataPoints = int(filtered.size());
+    if (!filtered.isEmpty()) {
+        stats.mean = StatsKernels::mean(moments);
+        stats.median = calculateMedian(filtered);
+        stats.variance = StatsKernels::variance(moments);
+        stats.standardDeviation = std::sqrt(stats.variance);
+        stats.minValue = moments.minValue;
+        stats.maxValue = moments.maxValue;
+        stats.range = stats.maxValue - stats.minValue;
+        stats.totalSum = StatsKernels::rawSum(moments);
+        stats.totalSquaredSum = StatsKernels::rawSumSquares(moments);
+    }
+    stats.startTime = m_processingStartTime;
+    stats.endTime = QDateTime::currentDateTime();
+    m_currentStatistics = stats;
+    emit statisticsCalculated(stats);
+}
+
+WorkStealingThreadPool *DataProcessor::pipelinePool()
+{
+    if (!m_pipelinePool) {
+        m_pipelinePool = std::make_unique<WorkStealingThreadPool>(m_pipelineThreads);
+    }
+    return m_pipelinePool.get();
+}
+
+void DataProcessor::setPipelineThreads(int threads)
+{
+    QMutexLocker locker(&m_processingMutex);
+    threads = qMax(1, threads);
+    if (threads != m_pipelineThreads) {
+        m_pipelineThreads = threads;
+        // Counters from another thread count would skew throughput figures
+        m_pipeline.setPool(nullptr);
+        m_pipeline.resetCounters();
+        m_pipelinePool.reset();
+    }
+}
+
+int DataProcessor::getPipelineThreads() const
+{
+    return m_pipelineThreads;
+}
+
+void DataProcessor::setValidRange(double minValue, double maxValue)
+{
+    m_validMin = minValue;
+    m_validMax = maxValue;
+}
+
+DataPipeline::StageCounters DataProcessor::getPipelineCounters(DataPipeline::Stage stage) const
+{
+    return m_pipeline.counters(stage);
+}
+
+void DataProcessor::onProcessingTimer()
+{
+    QVector<double> batch;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        for (const ProcessedData &data : m_processedData) {
+            batch.append(data.processedValue);
+        }
+    }
+    
+    if (batch.size() >= m_batchSize) {
+        processBatch(batch);
+    }
+}
+
+void DataProcessor::onRealTimeProcessing()
+{
+    processRealTimeData();
+}
+
+void DataProcessor::processBatch(const QVector<double>& data)
+{
+    if (m_processingMode == PARALLEL_PROCESSING_MODE) {
+        runPipeline(data);
+        return;
+    }
+    
+    QMutexLocker locker(&m_processingMutex);
+    m_isProcessing = true;
+    
+    // The pipeline's stages run one after another on this thread, with its
+    // chunking for the moments, so the mode changes the speed, not the result
+    QVector<bool> valid = validateDataPoints(data, m_validMin, m_validMax);
+    std::vector<std::unique_ptr<StreamingFilter>> filters = createStreamingFilters();
+    QVector<double> filtered;
+    filtered.reserve(data.size());
+    StatsKernels::Moments moments = {};
+    int chunkSize = m_pipeline.chunkSize();
+    for (int first = 0; first < data.size(); first += chunkSize) {
+        int chunkStart = int(filtered.size());
+        int last = int(qMin<qint64>(data.size(), qint64(first) + chunkSize));
+        for (int i = first; i < last; ++i) {
+            if (!valid[i]) {
+                continue;
+            }
+            double value = data[i];
+            for (const auto &filter : filters) {
+                value = filter->push(value);
+            }
+            filtered.append(value);
+        }
+        StatsKernels::Moments chunk = StatsKernels::moments(filtered.constData() + chunkStart, filtered.size() - chunkStart);
+        moments = StatsKernels::combine(moments, chunk);
+    }
+    finishBatch(filtered, moments);
+    
+    m_isProcessing = false;
+}
+
+QVector<double> DataProcessor::applyMovingAverageFilter(const QVector<double>& data, int windowSize)
+{
+    // Trailing window, shorter at the start of the series
+    StreamingMovingAverage filter(windowSize);
+    QVector<double> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = filter.push(data[i]);
+    }
+    return result;
+}
+
+QVector<double> DataProcessor::applyMedianFilter(const QVector<double>& data, int windowSize)
+{
+    StreamingMedian filter(windowSize);
+    QVector<double> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = filter.push(data[i]);
+    }
+    return result;
+}
+
+QVector<double> DataProcessor::applyGaussianFilter(const QVector<double>& data, double sigma)
+{
+    // Centred kernel truncated at three sigma, renormalised at the edges
+    int radius = qMax(1, int(std::ceil(sigma * 3.0)));
+    QVector<double> weights(radius + 1);
+    for (int offset = 0; offset <= radius; ++offset) {
+        weights[offset] = std::exp(-(offset * offset) / (2.0 * sigma * sigma));
+    }
+    
+    QVector<double> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        double sum = 0.0;
+        double weightSum = 0.0;
+        for (int offset = -radius; offset <= radius; ++offset) {
+            int j = i + offset;
+            if (j < 0 || j >= data.size()) {
+                continue;
+            }
+            double weight = weights[qAbs(offset)];
+            sum += data[j] * weight;
+            weightSum += weight;
+        }
+        result[i] = sum / weightSum;
+    }
+    return result;
+}
+
+QVector<double> DataProcessor::applyKalmanFilter(const QVector<double>& data, double processNoise, double measurementNoise)
+{
+    StreamingKalman filter(processNoise, measurementNoise);
+    QVector<double> result(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        result[i] = filter.push(data[i]);
+    }
+    return result;
+}
+
+double DataProcessor::calculatePercentile(const QVector<double>& data, double percentile)
+{
+    // Linear interpolation between the closest ranks, found by selection
+    return OrderStatistics::percentile(data, percentile);
+}
+
+bool DataProcessor::isOutlier(double value, const QVector<double>& data, double threshold)
+{
+    double deviation = calculateStandardDeviation(data);
+    if (deviation <= 0.0) {
+        return false;
+    }
+    return std::abs(value - calculateMean(data)) > threshold * deviation;
+}
+
+QString DataProcessor::generateProcessingReport(const QVector<double>& originalData, const QVector<double>& processedData)
+{
+    DataStatistics before = calculateStatistics(originalData);
+    DataStatistics after = calculateStatistics(processedData);
+    
+    return QString("Processed %1 -> %2 points; mean %3 -> %4; std dev %5 -> %6")
+        .arg(before.dataPoints).arg(after.dataPoints)
+        .arg(before.mean).arg(after.mean)
+        .arg(before.standardDeviation).arg(after.standardDeviation);
+}
+
+void DataProcessor::processRealTimeData()
+{
+    QVector<QPair<double, QDateTime>> pending;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        pending = m_realTimeBuffer;
+        m_realTimeBuffer.clear();
+    }
+    
+    if (pending.isEmpty()) {
+        return;
+    }
+    
+    if (m_streamingFiltersDirty) {
+        rebuildStreamingFilters();
+    }
+    
+    QVector<ProcessedData> processed;
+    processed.reserve(pending.size());
+    for (const auto &sample : pending) {
+        double value = sample.first;
+        for (const auto &filter : m_streamingFilters) {
+            value = filter->push(value);
+        }
+    
+        ProcessedData data;
+        data.originalValue = sample.first;
+        data.processedValue = value;
+        data.timestamp = sample.second;
+        data.processingMethod = m_processingMode;
+        data.isValid = std::isfinite(sample.first);
+        processed.append(data);
+    
+        emit realTimeDataProcessed(data);
+    }
+    
+    {
+        QMutexLocker locker(&m_dataMutex);
+        m_processedData += processed;
+        for (const ProcessedData &data : processed) {
+            m_realTimeQuantiles.add(data.processedValue);
+        }
+        if (m_processedData.size() > REAL_TIME_BUFFER_SIZE) {
+            m_processedData.remove(0, m_processedData.size() - REAL_TIME_BUFFER_SIZE);
+        }
+    }
+    m_totalProcessedPoints += processed.size();
+    
+    emit dataProcessed(processed);
+}
+
+void DataProcessor::rebuildStreamingFilters()
+{
+    m_streamingFilters = createStreamingFilters();
+    m_streamingFiltersDirty = false;
+    
+    // A changed chain is warmed up on the samples already processed, once,
+    // so the next output matches what the old refilter-everything path gave
+    QVector<double> history;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        history.reserve(m_processedData.size());
+        for (const ProcessedData &data : m_processedData) {
+            history.append(data.originalValue);
+        }
+    }
+    for (double value : history) {
+        for (const auto &filter : m_streamingFilters) {
+            value = filter->push(value);
+        }
+    }
+}
+
+std::vector<std::unique_ptr<StreamingFilter>> DataProcessor::createStreamingFilters()
+{
+    std::vector<std::unique_ptr<StreamingFilter>> filters;
+    for (const DataFilter &filter : m_filters) {
+        if (!filter.isEnabled) {
+            continue;
+        }
+        if (std::unique_ptr<StreamingFilter> streaming = createStreamingFilter(filter)) {
+            filters.push_back(std::move(streaming));
+        } else {
+            emit errorOccurred(QString("Unknown filter type: %1").arg(filter.type));
+        }
+    }
+    return filters;
+}
+
+std::unique_ptr<StreamingFilter> DataProcessor::createStreamingFilter(const DataFilter& filter)
+{
+    // Same window and sigma defaults as filterData()
+    double parameter = filter.parameter1;
+    if (filter.type == "moving_average") {
+        return std::make_unique<StreamingMovingAverage>(parameter > 0 ? int(parameter) : 5);
+    } else if (filter.type == "median") {
+        return std::make_unique<StreamingMedian>(parameter > 0 ? int(parameter) : 5);
+    } else if (filter.type == "gaussian") {
+        return std::make_unique<StreamingGaussian>(parameter > 0 ? parameter : 1.0);
+    } else if (filter.type == "kalman") {
+        return std::make_unique<StreamingKalman>(parameter, filter.parameter2 > 0 ? filter.parameter2 : 1.0);
+    }
+    return nullptr;
+}
+
+void DataProcessor::addToRealTimeBuffer(double value, const QDateTime& timestamp)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_realTimeBuffer.append(qMakePair(value, timestamp));
+    if (m_realTimeBuffer.size() > REAL_TIME_BUFFER_SIZE) {
+        m_realTimeBuffer.removeFirst();
+    }
+}
+
+void DataProcessor::flushRealTimeBuffer()
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_realTimeBuffer.clear();
+}
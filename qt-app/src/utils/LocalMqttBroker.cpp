@@ -0,0 +1,327 @@
+#include "utils/LocalMqttBroker.h"
+#include "utils/MqttWireTrace.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QDebug>
+#include <cstring>
+
+LocalMqttBroker::LocalMqttBroker(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_publishesReceived(0)
+    , m_bytesReceived(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &LocalMqttBroker::acceptClients);
+}
+
+LocalMqttBroker::~LocalMqttBroker()
+{
+    close();
+}
+
+bool LocalMqttBroker::listen(const QHostAddress &address, quint16 port)
+{
+    return m_server->listen(address, port);
+}
+
+void LocalMqttBroker::close()
+{
+    m_server->close();
+    
+    for (Client *client : m_clients) {
+        client->socket->disconnect(this);
+        client->socket->abort();
+        client->socket->deleteLater();
+        delete client;
+    }
+    m_clients.clear();
+}
+
+bool LocalMqttBroker::isListening() const
+{
+    return m_server->isListening();
+}
+
+quint16 LocalMqttBroker::serverPort() const
+{
+    return m_server->serverPort();
+}
+
+QString LocalMqttBroker::errorString() const
+{
+    return m_server->errorString();
+}
+
+bool LocalMqttBroker::topicMatches(const QByteArray &filter, const QByteArray &topic)
+{
+    // Level by level: + matches exactly one level, a trailing # the rest
+    int f = 0;
+    int t = 0;
+    while (f < filter.size()) {
+        int filterEnd = filter.indexOf('/', f);
+        if (filterEnd < 0) {
+            filterEnd = int(filter.size());
+        }
+        int filterLevel = filterEnd - f;
+    
+        if (filterLevel == 1 && filter[f] == '#') {
+            return true;
+        }
+        if (t > topic.size()) {
+            return false;
+        }
+    
+        int topicEnd = topic.indexOf('/', t);
+        if (topicEnd < 0) {
+            topicEnd = int(topic.size());
+        }
+    
+        bool wildcard = filterLevel == 1 && filter[f] == '+';
+        if (!wildcard && (topicEnd - t != filterLevel
+                          || memcmp(filter.constData() + f, topic.constData() + t, size_t(filterLevel)) != 0)) {
+            return false;
+        }
+    
+        f = filterEnd + 1;
+        t = topicEnd + 1;
+    }
+    return t > topic.size() && f > filter.size();
+}
+
+void LocalMqttBroker::acceptClients()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        socket->setParent(this);
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    
+        Client *client = new Client;
+        client->socket = socket;
+        client->packetId = 0;
+        client->connected = false;
+        m_clients.insert(socket, client);
+    
+        connect(socket, &QTcpSocket::readyRead, this, [this, client]() {
+            readClient(client);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, client]() {
+            dropClient(client, QString());
+        });
+    }
+}
+
+void LocalMqttBroker::readClient(Client *client)
+{
+    QTcpSocket *socket = client->socket;
+    qint64 available = socket->bytesAvailable();
+    while (available > 0) {
+        int chunk = int(qMin<qint64>(available, 64 * 1024));
+        qint64 received = socket->read(client->decoder.prepareWrite(chunk), chunk);
+        if (received <= 0) {
+            break;
+        }
+        client->decoder.commitWrite(int(received));
+        m_bytesReceived += quint64(received);
+    
+        MqttFrame frame;
+        MqttFrameDecoder::Status status;
+        while ((status = client->decoder.next(frame)) == MqttFrameDecoder::FrameReady) {
+            MQTT_TRACE_PACKET("broker <<", frame);
+            if (!handleFrame(client, frame)) {
+                return;
+            }
+        }
+    
+        if (status == MqttFrameDecoder::Malformed) {
+            dropClient(client, client->decoder.errorString());
+            return;
+        }
+    
+        available = socket->bytesAvailable();
+    }
+}
+
+bool LocalMqttBroker::handleFrame(Client *client, const MqttFrame &frame)
+{
+    if (!client->connected && frame.type() != MqttFrame::Connect) {
+        dropClient(client, "packet before CONNECT");
+        return false;
+    }
+    
+    switch (frame.type()) {
+    case MqttFrame::Connect:
+        return handleConnect(client, frame);
+    
+    case MqttFrame::Subscribe:
+        return handleSubscribe(client, frame);
+    
+    case MqttFrame::Publish:
+        return handlePublish(client, frame);
+    
+    case MqttFrame::Puback:
+        // Forwarding is at most once; nothing waits on the acknowledgement
+        return true;
+    
+    case MqttFrame::Pingreq:
+        m_encoder.encodePingResp();
+        send(client);
+        return true;
+    
+    case MqttFrame::Disconnect:
+        dropClient(client, QString());
+        return false;
+    
+    default:
+        dropClient(client, QString("unsupported packet type %1").arg(frame.type()));
+        return false;
+    }
+}
+
+bool LocalMqttBroker::handleConnect(Client *client, const MqttFrame &frame)
+{
+    // Protocol name "MQTT", level, flags, keep alive, then the client id
+    const uchar *body = reinterpret_cast<const uchar *>(frame.body);
+    if (client->connected || frame.bodySize < 12 || memcmp(frame.body, "\0\4MQTT", 6) != 0) {
+        dropClient(client, "invalid CONNECT");
+        return false;
+    }
+    
+    if (body[6] != 0x04) {
+        // Unacceptable protocol version
+        m_encoder.encodeConnAck(false, 0x01);
+        send(client);
+        dropClient(client, "unsupported protocol level");
+        return false;
+    }
+    
+    int clientIdSize = (body[10] << 8) | body[11];
+    if (12 + clientIdSize > frame.bodySize) {
+        dropClient(client, "invalid CONNECT");
+        return false;
+    }
+    
+    client->clientId = QByteArray(frame.body + 12, clientIdSize);
+    client->connected = true;
+    m_encoder.encodeConnAck(false, 0x00);
+    send(client);
+    emit clientConnected(QString::fromUtf8(client->clientId));
+    return true;
+}
+
+bool LocalMqttBroker::handleSubscribe(Client *client, const MqttFrame &frame)
+{
+    const uchar *body = reinterpret_cast<const uchar *>(frame.body);
+    if (frame.flags() != 0x02 || frame.bodySize < 2) {
+        dropClient(client, "invalid SUBSCRIBE");
+        return false;
+    }
+    
+    quint16 packetId = quint16((body[0] << 8) | body[1]);
+    QByteArray returnCodes;
+    QVector<QByteArray> filters;
+    int offset = 2;
+    while (offset < frame.bodySize) {
+        if (offset + 2 > frame.bodySize) {
+            break;
+        }
+        int filterSize = (body[offset] << 8) | body[offset + 1];
+        if (offset + 2 + filterSize + 1 > frame.bodySize) {
+            break;
+        }
+    
+        Subscription subscription;
+        subscription.filter = QByteArray(frame.body + offset + 2, filterSize);
+        subscription.qos = qMin<quint8>(body[offset + 2 + filterSize] & 0x03, 1);
+        offset += 2 + filterSize + 1;
+    
+        // A repeated filter replaces the earlier subscription
+        bool replaced = false;
+        for (Subscription &existing : client->subscriptions) {
+            if (existing.filter == subscription.filter) {
+                existing.qos = subscription.qos;
+                replaced = true;
+            }
+        }
+        if (!replaced) {
+            client->subscriptions.append(subscription);
+        }
+        returnCodes.append(char(subscription.qos));
+        filters.append(subscription.filter);
+    }
+    
+    if (offset != frame.bodySize || returnCodes.isEmpty()) {
+        dropClient(client, "invalid SUBSCRIBE");
+        return false;
+    }
+    
+    m_encoder.encodeSubAck(packetId, returnCodes);
+    send(client);
+    for (const QByteArray &filter : filters) {
+        emit clientSubscribed(QString::fromUtf8(client->clientId), QString::fromUtf8(filter));
+    }
+    return true;
+}
+
+bool LocalMqttBroker::handlePublish(Client *client, const MqttFrame &frame)
+{
+    MqttPublish publish;
+    if (!MqttFrameDecoder::decodePublish(frame, publish) || publish.qos > 1) {
+        dropClient(client, "invalid or QoS 2 PUBLISH");
+        return false;
+    }
+    
+    ++m_publishesReceived;
+    if (publish.qos == 1) {
+        m_encoder.encodePubAck(publish.packetId);
+        send(client);
+    }
+    emit publishReceived(publish);
+    
+    // The topic is only borrowed from the frame for matching and encoding
+    QByteArray topic = QByteArray::fromRawData(publish.topic, publish.topicSize);
+    for (Client *subscriber : m_clients) {
+        quint8 qos = 0;
+        bool matched = false;
+        for (const Subscription &subscription : subscriber->subscriptions) {
+            if (topicMatches(subscription.filter, topic)) {
+                qos = qMax(qos, subscription.qos);
+                matched = true;
+            }
+        }
+        if (!matched) {
+            continue;
+        }
+    
+        qos = qMin(qos, publish.qos);
+        quint16 packetId = 0;
+        if (qos > 0) {
+            subscriber->packetId = subscriber->packetId % 0xFFFF + 1;
+            packetId = subscriber->packetId;
+        }
+        m_encoder.encodePublish(topic, publish.payload, publish.payloadSize, qos, packetId);
+        send(subscriber);
+    }
+    return true;
+}
+
+void LocalMqttBroker::send(Client *client)
+{
+    MQTT_TRACE_PACKET("broker >>", m_encoder.data(), m_encoder.size());
+    client->socket->write(m_encoder.data(), m_encoder.size());
+}
+
+void LocalMqttBroker::dropClient(Client *client, const QString &reason)
+{
+    if (!m_clients.remove(client->socket)) {
+        return;
+    }
+    
+    if (!reason.isEmpty()) {
+        qDebug() << "Broker dropping client" << client->clientId << ":" << reason;
+    }
+    
+    // Still inside the socket's own signal handlers, so it is deleted later
+    client->socket->disconnect(this);
+    client->socket->disconnectFromHost();
+    client->socket->deleteLater();
+    delete client;
+}
@@ -0,0 +1,154 @@
+#include "utils/MqttFrameDecoder.h"
+#include <cstring>
+
+// Far above any telemetry packet, low enough that a corrupt length field
+// cannot make the decoder buffer hundreds of megabytes
+const int MqttFrameDecoder::DEFAULT_MAX_PACKET_SIZE = 256 * 1024;
+
+MqttFrameDecoder::MqttFrameDecoder(int maxPacketSize)
+    : m_readPos(0)
+    , m_writePos(0)
+    , m_maxPacketSize(qMax(2, maxPacketSize))
+    , m_malformed(false)
+    , m_framesDecoded(0)
+{
+}
+
+char *MqttFrameDecoder::prepareWrite(int size)
+{
+    // Move the unread tail to the front only when it is needed to make room;
+    // usually every byte was consumed and this is free.
+    int unread = m_writePos - m_readPos;
+    if (m_readPos > 0 && m_writePos + size > m_buffer.size()) {
+        std::memmove(m_buffer.data(), m_buffer.constData() + m_readPos, size_t(unread));
+        m_readPos = 0;
+        m_writePos = unread;
+    }
+
+    if (m_writePos + size > m_buffer.size()) {
+        m_buffer.resize(qMax(m_writePos + size, int(m_buffer.size()) * 2));
+    }
+
+    return m_buffer.data() + m_writePos;
+}
+
+void MqttFrameDecoder::commitWrite(int size)
+{
+    m_writePos += qBound(0, size, int(m_buffer.size()) - m_writePos);
+}
+
+void MqttFrameDecoder::append(const char *data, int size)
+{
+    if (size > 0) {
+        std::memcpy(prepareWrite(size), data, size_t(size));
+        commitWrite(size);
+    }
+}
+
+MqttFrameDecoder::Status MqttFrameDecoder::next(MqttFrame &frame)
+{
+    if (m_malformed) {
+        return Malformed;
+    }
+
+    int available = m_writePos - m_readPos;
+    if (available < 2) {
+        return NeedMoreData;
+    }
+
+    const uchar *data = reinterpret_cast<const uchar *>(m_buffer.constData()) + m_readPos;
+    quint8 header = data[0];
+    int type = header >> 4;
+    if (type == 0 || type == 15) {
+        return fail(QString("Reserved MQTT packet type %1").arg(type));
+    }
+
+    // Remaining length: 7 bits per byte, least significant first, at most four bytes
+    int length = 0;
+    int shift = 0;
+    int headerSize = 1;
+    for (;;) {
+        if (headerSize >= available) {
+            return NeedMoreData;
+        }
+        quint8 byte = data[headerSize++];
+        length |= (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+        if (headerSize == 5) {
+            return fail("MQTT remaining length longer than four bytes");
+        }
+        shift += 7;
+    }
+
+    if (length > m_maxPacketSize) {
+        return fail(QString("MQTT packet of %1 bytes exceeds the %2 byte limit").arg(length).arg(m_maxPacketSize));
+    }
+    if (available - headerSize < length) {
+        return NeedMoreData;
+    }
+
+    frame.header = header;
+    frame.body = reinterpret_cast<const char *>(data) + headerSize;
+    frame.bodySize = length;
+
+    m_readPos += headerSize + length;
+    if (m_readPos == m_writePos) {
+        // The bytes stay in place, so frame.body is still valid
+        m_readPos = 0;
+        m_writePos = 0;
+    }
+    ++m_framesDecoded;
+    return FrameReady;
+}
+
+void MqttFrameDecoder::reset()
+{
+    m_readPos = 0;
+    m_writePos = 0;
+    m_malformed = false;
+    m_errorString.clear();
+}
+
+bool MqttFrameDecoder::decodePublish(const MqttFrame &frame, MqttPublish &publish)
+{
+    if (frame.type() != MqttFrame::Publish || frame.bodySize < 2) {
+        return false;
+    }
+
+    const uchar *body = reinterpret_cast<const uchar *>(frame.body);
+    int topicSize = (body[0] << 8) | body[1];
+    int offset = 2 + topicSize;
+
+    publish.qos = (frame.flags() >> 1) & 0x03;
+    publish.retain = frame.flags() & 0x01;
+    if (publish.qos == 3) {
+        return false;
+    }
+
+    publish.packetId = 0;
+    if (publish.qos > 0) {
+        if (offset + 2 > frame.bodySize) {
+            return false;
+        }
+        publish.packetId = quint16((body[offset] << 8) | body[offset + 1]);
+        offset += 2;
+    }
+    if (offset > frame.bodySize) {
+        return false;
+    }
+
+    publish.topic = frame.body + 2;
+    publish.topicSize = topicSize;
+    publish.payload = frame.body + offset;
+    publish.payloadSize = frame.bodySize - offset;
+    return true;
+}
+
+MqttFrameDecoder::Status MqttFrameDecoder::fail(const QString &error)
+{
+    m_malformed = true;
+    m_errorString = error;
+    return Malformed;
+}
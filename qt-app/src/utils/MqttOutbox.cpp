@@ -0,0 +1,234 @@
+#include "utils/MqttOutbox.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+const quint32 MqttOutbox::MAGIC = 0x4F535356; // "VSSO" read as little-endian
+const quint16 MqttOutbox::VERSION = 1;
+
+// Bounds memory and disk while the broker is unreachable; the oldest
+// messages are dropped first
+const int MqttOutbox::DEFAULT_MAX_MESSAGES = 10000;
+
+// Acknowledgements logged before the log is considered for rewriting
+static const int COMPACT_THRESHOLD = 1024;
+
+static const int LOG_HEADER_SIZE = 6;
+
+MqttOutbox::MqttOutbox(int maxMessages)
+    : m_nextSequence(1)
+    , m_maxMessages(qMax(1, maxMessages))
+    , m_droppedCount(0)
+    , m_loggedAcks(0)
+{
+}
+
+MqttOutbox::~MqttOutbox()
+{
+    close();
+}
+
+bool MqttOutbox::open(const QString &path)
+{
+    close();
+    m_file.setFileName(path);
+    m_errorString.clear();
+
+    // Messages queued before the log was opened go after the logged ones
+    QMap<quint64, Message> unlogged;
+    unlogged.swap(m_pending);
+    m_nextSequence = 1;
+
+    if (m_file.exists() && !load()) {
+        m_pending.swap(unlogged);
+        return false;
+    }
+
+    for (Message message : unlogged) {
+        message.sequence = m_nextSequence++;
+        m_pending.insert(message.sequence, message);
+    }
+
+    // Start from a log holding exactly the pending messages
+    return compact();
+}
+
+void MqttOutbox::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+quint64 MqttOutbox::enqueue(const QByteArray &topic, const QByteArray &payload)
+{
+    while (m_pending.size() >= m_maxMessages) {
+        quint64 oldest = m_pending.firstKey();
+        m_pending.remove(oldest);
+        encodeAck(oldest);
+        writeRecord();
+        ++m_loggedAcks;
+        ++m_droppedCount;
+    }
+
+    Message message = { m_nextSequence++, topic, payload, 0 };
+    m_pending.insert(message.sequence, message);
+    encodeEnqueue(message);
+    writeRecord();
+    // Drops log acks too, and nothing is acknowledged while the broker is
+    // unreachable
+    maybeCompact();
+    return message.sequence;
+}
+
+bool MqttOutbox::acknowledge(quint64 sequence)
+{
+    if (m_pending.remove(sequence) == 0) {
+        return false;
+    }
+
+    encodeAck(sequence);
+    writeRecord();
+    ++m_loggedAcks;
+    maybeCompact();
+    return true;
+}
+
+MqttOutbox::Message *MqttOutbox::nextAfter(quint64 sequence)
+{
+    auto it = m_pending.upperBound(sequence);
+    return it == m_pending.end() ? nullptr : &it.value();
+}
+
+bool MqttOutbox::load()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    QByteArray log = m_file.readAll();
+    m_file.close();
+
+    const uchar *data = reinterpret_cast<const uchar *>(log.constData());
+    int size = int(log.size());
+    if (size < LOG_HEADER_SIZE || qFromLittleEndian<quint32>(data) != MAGIC
+        || qFromLittleEndian<quint16>(data + 4) != VERSION) {
+        m_errorString = QString("%1 is not an outbox log").arg(m_file.fileName());
+        return false;
+    }
+
+    int offset = LOG_HEADER_SIZE;
+    while (offset + 9 <= size) {
+        quint8 kind = data[offset];
+        quint64 sequence = qFromLittleEndian<quint64>(data + offset + 1);
+        int next = offset + 9;
+
+        if (kind == EnqueueRecord) {
+            if (next + 2 > size) {
+                break;
+            }
+            int topicSize = qFromLittleEndian<quint16>(data + next);
+            if (next + 2 + topicSize + 4 > size) {
+                break;
+            }
+            quint32 payloadSize = qFromLittleEndian<quint32>(data + next + 2 + topicSize);
+            if (payloadSize > quint32(size - (next + 6 + topicSize))) {
+                break;
+            }
+
+            // Anything loaded may already have reached the broker once
+            Message message;
+            message.sequence = sequence;
+            message.topic = log.mid(next + 2, topicSize);
+            message.payload = log.mid(next + 6 + topicSize, int(payloadSize));
+            message.attempts = 1;
+            m_pending.insert(sequence, message);
+            next += 6 + topicSize + int(payloadSize);
+        } else if (kind == AckRecord) {
+            m_pending.remove(sequence);
+        } else {
+            break;
+        }
+
+        m_nextSequence = qMax(m_nextSequence, sequence + 1);
+        offset = next;
+    }
+
+    return true;
+}
+
+void MqttOutbox::maybeCompact()
+{
+    // Rewrite once the log is mostly acknowledged history
+    if (m_loggedAcks >= COMPACT_THRESHOLD && m_loggedAcks > 4 * m_pending.size()) {
+        compact();
+    }
+}
+
+bool MqttOutbox::compact()
+{
+    QString path = m_file.fileName();
+    if (path.isEmpty()) {
+        return true;
+    }
+    m_file.close();
+
+    // QSaveFile replaces the old log only once the new one is complete
+    QSaveFile log(path);
+    if (!log.open(QIODevice::WriteOnly)) {
+        m_errorString = log.errorString();
+        return false;
+    }
+
+    m_record.resize(LOG_HEADER_SIZE);
+    qToLittleEndian<quint32>(MAGIC, m_record.data());
+    qToLittleEndian<quint16>(VERSION, m_record.data() + 4);
+    log.write(m_record);
+    for (const Message &message : m_pending) {
+        encodeEnqueue(message);
+        log.write(m_record);
+    }
+
+    if (!log.commit()) {
+        m_errorString = log.errorString();
+        return false;
+    }
+
+    m_loggedAcks = 0;
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void MqttOutbox::encodeEnqueue(const Message &message)
+{
+    int topicSize = int(message.topic.size());
+    int payloadSize = int(message.payload.size());
+    m_record.resize(9 + 2 + topicSize + 4 + payloadSize);
+
+    char *out = m_record.data();
+    out[0] = char(EnqueueRecord);
+    qToLittleEndian<quint64>(message.sequence, out + 1);
+    qToLittleEndian<quint16>(quint16(topicSize), out + 9);
+    memcpy(out + 11, message.topic.constData(), size_t(topicSize));
+    qToLittleEndian<quint32>(quint32(payloadSize), out + 11 + topicSize);
+    memcpy(out + 15 + topicSize, message.payload.constData(), size_t(payloadSize));
+}
+
+void MqttOutbox::encodeAck(quint64 sequence)
+{
+    m_record.resize(9);
+    m_record[0] = char(AckRecord);
+    qToLittleEndian<quint64>(sequence, m_record.data() + 1);
+}
+
+void MqttOutbox::writeRecord()
+{
+    // Flushed per record so a crash loses at most the one being written
+    if (m_file.isOpen()) {
+        m_file.write(m_record);
+        m_file.flush();
+    }
+}
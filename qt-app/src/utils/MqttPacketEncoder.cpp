@@ -0,0 +1,141 @@
+#include "utils/MqttPacketEncoder.h"
+#include <cstring>
+
+// Room for CONNECT, SUBSCRIBE and a typical speed report without growing
+const int MqttPacketEncoder::DEFAULT_CAPACITY = 512;
+
+MqttPacketEncoder::MqttPacketEncoder(int initialCapacity)
+    : m_buffer(qMax(16, initialCapacity), Qt::Uninitialized)
+    , m_size(0)
+{
+}
+
+int MqttPacketEncoder::encodeConnect(const QByteArray &clientId, quint16 keepAliveSeconds, bool cleanSession)
+{
+    // Protocol name, level, flags and keep alive, then the client id
+    int remainingLength = 10 + 2 + int(clientId.size());
+    char *out = beginPacket(0x10, remainingLength);
+
+    out = writeString(out, QByteArray::fromRawData("MQTT", 4));
+    *out++ = char(0x04); // Protocol level 3.1.1
+    *out++ = char(cleanSession ? 0x02 : 0x00);
+    out = writeUInt16(out, keepAliveSeconds);
+    writeString(out, clientId);
+
+    return m_size;
+}
+
+int MqttPacketEncoder::encodeSubscribe(quint16 packetId, const QByteArray &topic, quint8 qos)
+{
+    int remainingLength = 2 + 2 + int(topic.size()) + 1;
+    char *out = beginPacket(0x82, remainingLength);
+
+    out = writeUInt16(out, packetId);
+    out = writeString(out, topic);
+    *out = char(qos & 0x03);
+
+    return m_size;
+}
+
+int MqttPacketEncoder::encodePublish(const QByteArray &topic, const char *payload, int payloadSize,
+                                     quint8 qos, quint16 packetId, bool retain, bool dup)
+{
+    qos &= 0x03;
+    int remainingLength = 2 + int(topic.size()) + (qos > 0 ? 2 : 0) + payloadSize;
+    quint8 header = quint8(0x30 | (dup ? 0x08 : 0x00) | (qos << 1) | (retain ? 0x01 : 0x00));
+    char *out = beginPacket(header, remainingLength);
+
+    out = writeString(out, topic);
+    if (qos > 0) {
+        out = writeUInt16(out, packetId);
+    }
+    if (payloadSize > 0) {
+        std::memcpy(out, payload, size_t(payloadSize));
+    }
+
+    return m_size;
+}
+
+int MqttPacketEncoder::encodePublish(const QByteArray &topic, const QByteArray &payload,
+                                     quint8 qos, quint16 packetId, bool retain, bool dup)
+{
+    return encodePublish(topic, payload.constData(), int(payload.size()), qos, packetId, retain, dup);
+}
+
+int MqttPacketEncoder::encodePingReq()
+{
+    beginPacket(0xC0, 0);
+    return m_size;
+}
+
+int MqttPacketEncoder::encodeConnAck(bool sessionPresent, quint8 returnCode)
+{
+    char *out = beginPacket(0x20, 2);
+    *out++ = char(sessionPresent ? 0x01 : 0x00);
+    *out = char(returnCode);
+    return m_size;
+}
+
+int MqttPacketEncoder::encodeSubAck(quint16 packetId, const QByteArray &returnCodes)
+{
+    char *out = beginPacket(0x90, 2 + int(returnCodes.size()));
+    out = writeUInt16(out, packetId);
+    std::memcpy(out, returnCodes.constData(), size_t(returnCodes.size()));
+    return m_size;
+}
+
+int MqttPacketEncoder::encodePubAck(quint16 packetId)
+{
+    char *out = beginPacket(0x40, 2);
+    writeUInt16(out, packetId);
+    return m_size;
+}
+
+int MqttPacketEncoder::encodePingResp()
+{
+    beginPacket(0xD0, 0);
+    return m_size;
+}
+
+int MqttPacketEncoder::remainingLengthSize(int length)
+{
+    return length < 128 ? 1 : length < 16384 ? 2 : length < 2097152 ? 3 : 4;
+}
+
+char *MqttPacketEncoder::beginPacket(quint8 header, int remainingLength)
+{
+    m_size = 1 + remainingLengthSize(remainingLength) + remainingLength;
+    if (m_size > m_buffer.size()) {
+        m_buffer.resize(qMax(m_size, int(m_buffer.size()) * 2));
+    }
+
+    char *out = m_buffer.data();
+    *out++ = char(header);
+
+    // Remaining length: 7 bits per byte, least significant first
+    int length = remainingLength;
+    do {
+        quint8 digit = length % 128;
+        length /= 128;
+        if (length > 0) {
+            digit |= 0x80;
+        }
+        *out++ = char(digit);
+    } while (length > 0);
+
+    return out;
+}
+
+char *MqttPacketEncoder::writeUInt16(char *out, quint16 value)
+{
+    *out++ = char(value >> 8);
+    *out++ = char(value & 0xFF);
+    return out;
+}
+
+char *MqttPacketEncoder::writeString(char *out, const QByteArray &value)
+{
+    out = writeUInt16(out, quint16(value.size()));
+    std::memcpy(out, value.constData(), size_t(value.size()));
+    return out + value.size();
+}
@@ -0,0 +1,103 @@
+#include "utils/MqttWireTrace.h"
+#include <QByteArray>
+#include <QStringList>
+#include <QDebug>
+
+// Longer packets are dumped up to here and marked as truncated
+const int MqttWireTrace::MAX_DUMP_BYTES = 256;
+
+std::atomic<int> MqttWireTrace::s_level(MqttWireTrace::Off);
+std::atomic<int> MqttWireTrace::s_sampleInterval(1);
+std::atomic<quint32> MqttWireTrace::s_sampleCounter(0);
+
+namespace {
+
+const char *packetTypeName(quint8 header)
+{
+    static const char *const names[16] = {
+        "RESERVED", "CONNECT", "CONNACK", "PUBLISH", "PUBACK", "PUBREC", "PUBREL", "PUBCOMP",
+        "SUBSCRIBE", "SUBACK", "UNSUBSCRIBE", "UNSUBACK", "PINGREQ", "PINGRESP", "DISCONNECT", "RESERVED"
+    };
+    return names[header >> 4];
+}
+
+void trace(const char *direction, quint8 header, int packetSize, const char *bytes, int byteCount)
+{
+    if (MqttWireTrace::level() < MqttWireTrace::Bytes) {
+        qDebug().noquote() << "MQTT" << direction << packetTypeName(header) << packetSize << "bytes";
+        return;
+    }
+
+    int dumped = qMin(byteCount, MqttWireTrace::MAX_DUMP_BYTES);
+    QByteArray hex = QByteArray::fromRawData(bytes, dumped).toHex(' ');
+    if (dumped < byteCount) {
+        hex.append(" ...");
+    }
+    qDebug().noquote() << "MQTT" << direction << packetTypeName(header) << packetSize << "bytes:" << hex;
+}
+
+}
+
+void MqttWireTrace::setLevel(Level level)
+{
+    s_level.store(level, std::memory_order_relaxed);
+}
+
+void MqttWireTrace::setSampleInterval(int interval)
+{
+    s_sampleInterval.store(qMax(1, interval), std::memory_order_relaxed);
+}
+
+bool MqttWireTrace::configure(const QString &spec)
+{
+    // <level>[:<sample interval>], e.g. "bytes" or "packets:1000"
+    QStringList parts = spec.trimmed().toLower().split(':');
+    QString levelName = parts.value(0);
+    int interval = 1;
+    if (parts.size() > 1) {
+        bool ok = false;
+        interval = parts[1].toInt(&ok);
+        if (!ok || interval < 1) {
+            return false;
+        }
+    }
+
+    if (levelName == "off" || levelName == "0") {
+        setLevel(Off);
+    } else if (levelName == "packets" || levelName == "1") {
+        setLevel(Packets);
+    } else if (levelName == "bytes" || levelName == "2") {
+        setLevel(Bytes);
+    } else {
+        return false;
+    }
+    setSampleInterval(interval);
+    return true;
+}
+
+void MqttWireTrace::configureFromEnvironment()
+{
+    QByteArray spec = qgetenv("VSS_MQTT_TRACE");
+    if (!spec.isEmpty() && !configure(QString::fromLatin1(spec))) {
+        qWarning() << "Ignoring invalid VSS_MQTT_TRACE value:" << spec;
+    }
+}
+
+bool MqttWireTrace::sample()
+{
+    int interval = sampleInterval();
+    return interval <= 1 || s_sampleCounter.fetch_add(1, std::memory_order_relaxed) % quint32(interval) == 0;
+}
+
+void MqttWireTrace::tracePacket(const char *direction, const char *packet, int size)
+{
+    if (size > 0) {
+        trace(direction, quint8(packet[0]), size, packet, size);
+    }
+}
+
+void MqttWireTrace::tracePacket(const char *direction, const MqttFrame &frame)
+{
+    // The fixed header is already consumed, so only the body is dumped
+    trace(direction, frame.header, frame.bodySize, frame.body, frame.bodySize);
+}
@@ -0,0 +1,81 @@
+#include "utils/OrderStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OrderStatistics
+{
+
+static qint64 dropNaN(QVector<double> &data)
+{
+    auto end = std::remove_if(data.begin(), data.end(), [](double value) { return value != value; });
+    data.erase(end, data.end());
+    return data.size();
+}
+
+static double rankOf(double percentile, qint64 count)
+{
+    return qBound(0.0, percentile, 100.0) / 100.0 * (count - 1);
+}
+
+static double interpolate(double lower, double upper, double rank)
+{
+    return lower + (upper - lower) * (rank - std::floor(rank));
+}
+
+double percentile(QVector<double> data, double percentile)
+{
+    qint64 count = dropNaN(data);
+    if (count == 0) {
+        return 0.0;
+    }
+    
+    double rank = rankOf(percentile, count);
+    qint64 lower = qint64(std::floor(rank));
+    std::nth_element(data.begin(), data.begin() + lower, data.end());
+    if (lower + 1 >= count) {
+        return data[lower];
+    }
+    // Everything after the nth element is at least as large as it
+    double upper = *std::min_element(data.begin() + lower + 1, data.end());
+    return interpolate(data[lower], upper, rank);
+}
+
+QVector<double> percentiles(QVector<double> data, const QVector<double> &percentiles)
+{
+    QVector<double> result(percentiles.size(), 0.0);
+    qint64 count = dropNaN(data);
+    if (count == 0 || percentiles.isEmpty()) {
+        return result;
+    }
+    
+    // Both neighbouring ranks of every query, in ascending order
+    QVector<qint64> ranks;
+    for (double percentile : percentiles) {
+        qint64 lower = qint64(std::floor(rankOf(percentile, count)));
+        ranks.append(lower);
+        ranks.append(qMin(lower + 1, count - 1));
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    
+    if (ranks.size() > MAX_SELECTIONS) {
+        std::sort(data.begin(), data.end());
+    } else {
+        // Each selection leaves everything above its rank to the right of it,
+        // so the next one only has to search there
+        auto first = data.begin();
+        for (qint64 rank : ranks) {
+            std::nth_element(first, data.begin() + rank, data.end());
+            first = data.begin() + rank + 1;
+        }
+    }
+    
+    for (int i = 0; i < percentiles.size(); ++i) {
+        double rank = rankOf(percentiles[i], count);
+        qint64 lower = qint64(std::floor(rank));
+        result[i] = interpolate(data[lower], data[qMin(lower + 1, count - 1)], rank);
+    }
+    return result;
+}
+
+}
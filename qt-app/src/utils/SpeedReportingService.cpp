@@ -1,25 +1,91 @@
 #include "utils/SpeedReportingService.h"
+#include "utils/MqttWireTrace.h"
+#include <QElapsedTimer>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QRandomGenerator>
 #include <QTcpSocket>
 #include <QTimer>
 #include <QDebug>
 
+// Enough PUBLISHes in flight to cover the round trip to a remote broker at
+// the fleet's reporting rate; the broker's receive maximum is usually higher
+const int SpeedReportingService::DEFAULT_IN_FLIGHT_WINDOW = 32;
+
+// First retry after about a second, doubling up to a minute between attempts
+const int SpeedReportingService::DEFAULT_RECONNECT_DELAY_MS = 1000;
+const int SpeedReportingService::DEFAULT_MAX_RECONNECT_DELAY_MS = 60000;
+
+// A few seconds of a large fleet's reports; a power of two so the ring
+// holds exactly this many
+const int SpeedReportingService::OFFLINE_BUFFER_SIZE = 4096;
+
+// Drains a full offline buffer in about 20 seconds
+const int SpeedReportingService::DEFAULT_DRAIN_RATE = 200;
+
+static const int DRAIN_INTERVAL_MS = 50;
+
+// About four seconds of frames; the reporting thread drains it far sooner
+const int SpeedReportingService::REPORT_QUEUE_SIZE = 256;
+
 SpeedReportingService::SpeedReportingService(QObject *parent)
     : QObject(parent)
     , m_socket(new QTcpSocket(this))
     , m_reportingTimer(new QTimer(this))
     , m_speedThreshold(80.0)
-    , m_lastSentSpeed(0.0)
+    , m_port(1883)
     , m_isReporting(false)
     , m_isSubscribed(false)
     , m_clientId("mqttx_ada8b259")
     , m_packetId(1)
+    , m_clientIdBytes(m_clientId.toUtf8())
+    , m_publishTopic("vehicle/speed/publish")
+    , m_alertTopic("vehicle/speed/alert")
+    , m_batchTopic("vehicle/speed/batch")
+    , m_binaryPublishTopic(TelemetryCodec::topicFor(m_publishTopic, TelemetryCodec::Format::Binary))
+    , m_binaryBatchTopic(TelemetryCodec::topicFor(m_batchTopic, TelemetryCodec::Format::Binary))
+    , m_payloadFormat(TelemetryCodec::Format::Json)
+    , m_batchingEnabled(false)
+    , m_batchTimer(new QTimer(this))
+    , m_qos(0)
+    , m_inFlightWindow(DEFAULT_IN_FLIGHT_WINDOW)
+    , m_lastSentSequence(0)
+    , m_connectionState(Idle)
+    , m_reconnectTimer(new QTimer(this))
+    , m_reconnectAttempts(0)
+    , m_reconnectDelay(DEFAULT_RECONNECT_DELAY_MS)
+    , m_maxReconnectDelay(DEFAULT_MAX_RECONNECT_DELAY_MS)
+    , m_reportQueue(REPORT_QUEUE_SIZE)
+    , m_drainScheduled(false)
+    , m_enqueued(0)
+    , m_enqueueDropped(0)
+    , m_enqueueNanos(0)
+    , m_enqueueMaxNanos(0)
+    , m_offlineSamples(OFFLINE_BUFFER_SIZE)
+    , m_offlineCount(0)
+    , m_offlineDropped(0)
+    , m_drainTimer(new QTimer(this))
+    , m_drainRate(DEFAULT_DRAIN_RATE)
+    , m_drainCredit(0)
 {
     setupReportingTimer();
+    m_throttle.setAlertThreshold(m_speedThreshold);
+    
+    m_batchTimer->setSingleShot(true);
+    connect(m_batchTimer, &QTimer::timeout, this, &SpeedReportingService::flushBatch);
+    
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &SpeedReportingService::connectToBroker);
+    
+    m_drainTimer->setInterval(DRAIN_INTERVAL_MS);
+    connect(m_drainTimer, &QTimer::timeout, this, &SpeedReportingService::drainOffline);
+    
+    MqttWireTrace::configureFromEnvironment();
     
     connect(m_socket, &QTcpSocket::connected, this, [this]() {
         qDebug() << "Connected to MQTT broker";
+        m_decoder.reset();
         emit reportingStatusChanged(true);
         // Add a small delay to ensure connection is fully established
         QTimer::singleShot(100, this, &SpeedReportingService::sendMqttConnect);
@@ -28,87 +94,111 @@ SpeedReportingService::SpeedReportingService(QObject *parent)
     connect(m_socket, &QTcpSocket::disconnected, this, [this]() {
         qDebug() << "Disconnected from MQTT broker";
         m_isSubscribed = false;
+        m_inFlight.clear();
+        m_reportingTimer->stop();
+        m_drainTimer->stop();
+        // A pending batch goes to the offline buffer ahead of newer samples
+        flushBatch();
         emit reportingStatusChanged(false);
     });
     
+    // Covers both a dropped connection and a connect attempt that failed,
+    // which never emits disconnected
+    connect(m_socket, &QTcpSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+        if (state != QAbstractSocket::UnconnectedState) {
+            return;
+        }
+        m_connectionState = Idle;
+        if (m_isReporting) {
+            scheduleReconnect();
+        }
+    });
+    
     connect(m_socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError error) {
         QString errorMsg = QString("Socket error: %1").arg(m_socket->errorString());
         qDebug() << errorMsg;
         emit errorOccurred(errorMsg);
     });
     
-    connect(m_socket, &QTcpSocket::readyRead, this, [this]() {
-        QByteArray data = m_socket->readAll();
-        qDebug() << "Received data from broker:" << data.toHex();
-        
-        if (data.size() >= 4 && (data[0] & 0xF0) == 0x20) {
-            // CONNACK packet received
-            qDebug() << "CONNACK received - connection successful!";
-            emit reportingStatusChanged(true);
-            
-            // Subscribe to the topic for forwarding
-            QTimer::singleShot(500, this, [this]() {
-                qDebug() << "Subscribing to topic for forwarding";
-                sendMqttSubscribe("vehicle/speed/alert");
-            });
-            
-            // Start keep-alive timer
-            m_reportingTimer->start();
-        } else if (data.size() >= 4 && (data[0] & 0xF0) == 0x90) {
-            // SUBACK packet received
-            qDebug() << "SUBACK received - subscription successful!";
-            m_isSubscribed = true;
-            
-            // Send a test PUBLISH packet to keep connection alive
-            QTimer::singleShot(200, this, [this]() {
-                qDebug() << "Sending test PUBLISH packet to keep connection alive";
-                sendMqttPublish("vehicle/speed/publish", "{\"test\": \"connection_keepalive\"}");
-            });
-        } else if (data.size() >= 2 && (data[0] & 0xF0) == 0xD0) {
-            // PINGRESP packet received
-            qDebug() << "PINGRESP received - keep-alive successful!";
-        } else if (data.size() >= 4 && (data[0] & 0xF0) == 0x30) {
-            // PUBLISH packet received - forward it to Flutter topic
-            qDebug() << "PUBLISH received - forwarding to Flutter";
-            handleMqttMessage(data);
-        }
-    });
+    connect(m_socket, &QTcpSocket::readyRead, this, &SpeedReportingService::readMqttFrames);
 }
 
 SpeedReportingService::~SpeedReportingService()
 {
+    drainReportQueue();
     stopReporting();
 }
 
 void SpeedReportingService::startReporting(const QString &endpoint)
 {
     m_endpoint = endpoint;
-    
-    QString host = "broker.hivemq.com";
-    int port = 1883;
+    m_host = "broker.hivemq.com";
+    m_port = 1883;
     
     if (endpoint.contains(":")) {
         QStringList parts = endpoint.split(":");
         if (parts.size() >= 2) {
-            host = parts[0];
-            port = parts[1].toInt();
+            m_host = parts[0];
+            m_port = quint16(parts[1].toInt());
         }
     } else {
-        host = endpoint;
+        m_host = endpoint;
     }
     
-    qDebug() << "Connecting to MQTT broker:" << host << ":" << port;
-    m_socket->connectToHost(host, port);
     m_isReporting = true;
+    connectToBroker();
+    m_reconnectAttempts = 0;
+}
+
+void SpeedReportingService::connectToBroker()
+{
+    // Aborting schedules a reconnect of its own; this attempt replaces it
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+    m_reconnectTimer->stop();
+    
+    m_connectionState = Connecting;
+    qDebug() << "Connecting to MQTT broker:" << m_host << ":" << m_port;
+    m_socket->connectToHost(m_host, m_port);
+}
+
+void SpeedReportingService::scheduleReconnect()
+{
+    if (m_reconnectTimer->isActive()) {
+        return;
+    }
+    
+    // Equal jitter: half of the doubled delay is fixed and half random, so
+    // clients dropped by the same outage do not all come back at once
+    qint64 ceiling = qMin<qint64>(m_maxReconnectDelay, qint64(m_reconnectDelay) << qMin(m_reconnectAttempts, 20));
+    int delay = int(ceiling / 2) + QRandomGenerator::global()->bounded(int(ceiling - ceiling / 2) + 1);
+    ++m_reconnectAttempts;
+    
+    m_connectionState = WaitingToReconnect;
+    qDebug() << "Reconnecting to MQTT broker in" << delay << "ms, attempt" << m_reconnectAttempts;
+    m_reconnectTimer->start(delay);
+}
+
+void SpeedReportingService::setReconnectBackoff(int initialDelayMs, int maxDelayMs)
+{
+    m_reconnectDelay = qMax(1, initialDelayMs);
+    m_maxReconnectDelay = qMax(m_reconnectDelay, maxDelayMs);
 }
 
 void SpeedReportingService::stopReporting()
 {
+    flushBatch();
     m_isReporting = false;
     m_reportingTimer->stop();
+    m_reconnectTimer->stop();
+    clearOffline();
     if (m_socket->state() == QAbstractSocket::ConnectedState) {
         m_socket->disconnectFromHost();
+    } else {
+        m_socket->abort();
     }
+    m_connectionState = Idle;
     emit reportingStatusChanged(false);
 }
 
@@ -117,31 +207,205 @@ bool SpeedReportingService::isReporting() const
     return m_isReporting && m_socket->state() == QAbstractSocket::ConnectedState;
 }
 
-void SpeedReportingService::onSpeedChanged(double speed)
+bool SpeedReportingService::enqueueSpeed(qint32 vehicleId, double speed, qint64 timestamp)
 {
-    if (speed >= m_speedThreshold && qAbs(speed - m_lastSentSpeed) > 1.0) {
-        // Only send if we're fully connected, subscribed, and reporting
-        if (m_socket->state() == QAbstractSocket::ConnectedState && m_isReporting && m_isSubscribed) {
-            sendSpeedData(speed);
-            m_lastSentSpeed = speed;
+    QElapsedTimer timer;
+    timer.start();
+    
+    SpeedSample sample = { vehicleId, timestamp, speed };
+    bool queued = m_reportQueue.tryPush(sample);
+    if (queued) {
+        // Paired with the fence in drainReportQueue(): either the drain sees
+        // this sample or this call sees the flag cleared and posts a wake-up.
+        // One post per drain keeps the event queue lock off the common path.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_drainScheduled.exchange(true, std::memory_order_relaxed)) {
+            QMetaObject::invokeMethod(this, &SpeedReportingService::drainReportQueue, Qt::QueuedConnection);
         }
+    } else {
+        m_enqueueDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Single producer, so the maximum needs no compare-and-swap
+    quint64 nanos = quint64(timer.nsecsElapsed());
+    m_enqueued.fetch_add(1, std::memory_order_relaxed);
+    m_enqueueNanos.fetch_add(nanos, std::memory_order_relaxed);
+    if (nanos > m_enqueueMaxNanos.load(std::memory_order_relaxed)) {
+        m_enqueueMaxNanos.store(nanos, std::memory_order_relaxed);
     }
+    return queued;
 }
 
+SpeedReportingService::QueueStats SpeedReportingService::queueStats() const
+{
+    QueueStats stats;
+    stats.enqueued = m_enqueued.load(std::memory_order_relaxed);
+    stats.dropped = m_enqueueDropped.load(std::memory_order_relaxed);
+    stats.totalNanos = m_enqueueNanos.load(std::memory_order_relaxed);
+    stats.maxNanos = m_enqueueMaxNanos.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SpeedReportingService::drainReportQueue()
+{
+    m_drainScheduled.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    
+    SpeedSample sample;
+    while (m_reportQueue.tryPop(sample)) {
+        considerSpeed(sample);
+    }
+}
 
+void SpeedReportingService::onSpeedChanged(double speed)
+{
+    considerSpeed({ SpeedSample::PLAYER_VEHICLE, QDateTime::currentMSecsSinceEpoch(), speed });
+}
 
-QByteArray SpeedReportingService::encodeRemainingLength(int length)
+void SpeedReportingService::considerSpeed(const SpeedSample &sample)
 {
-    QByteArray encoded;
-    do {
-        int digit = length % 128;
-        length = length / 128;
-        if (length > 0) {
-            digit |= 0x80;
+    if (!m_isReporting) {
+        return;
+    }
+    
+    // The player's vehicle is only reported at or above the threshold
+    if (sample.vehicleId == SpeedSample::PLAYER_VEHICLE && sample.speed < m_speedThreshold) {
+        m_throttle.observe(sample);
+        return;
+    }
+    
+    switch (m_throttle.admit(sample)) {
+    case TelemetryThrottle::Suppressed:
+        break;
+    case TelemetryThrottle::Admitted:
+        reportSpeed(sample.vehicleId, sample.speed, sample.timestamp);
+        break;
+    case TelemetryThrottle::Alert:
+        publishAlert(sample);
+        break;
+    }
+}
+
+void SpeedReportingService::publishAlert(const SpeedSample &sample)
+{
+    // Ahead of any batch or offline backlog; only an unreachable broker
+    // holds an alert back
+    if (m_qos == 0 && !isOnline()) {
+        bufferOffline(sample);
+        return;
+    }
+    sendSpeedData(sample);
+}
+
+void SpeedReportingService::setSpeedThreshold(double threshold)
+{
+    m_speedThreshold = threshold;
+    m_throttle.setAlertThreshold(threshold);
+}
+
+void SpeedReportingService::setThrottleLimits(double deadband, int minIntervalMs, double maxRate, int burst)
+{
+    m_throttle.setDeadband(deadband);
+    m_throttle.setMinInterval(minIntervalMs);
+    m_throttle.setMaxRate(maxRate, burst);
+}
+
+void SpeedReportingService::reportSpeed(qint32 vehicleId, double speed, qint64 timestamp)
+{
+    if (!m_isReporting) {
+        return;
+    }
+    
+    // Anything still waiting in the offline buffer goes out first
+    SpeedSample sample = { vehicleId, timestamp, speed };
+    if (m_qos == 0 && (!isOnline() || m_offlineCount > 0)) {
+        bufferOffline(sample);
+        return;
+    }
+    submitSample(sample);
+}
+
+void SpeedReportingService::submitSample(const SpeedSample &sample)
+{
+    if (!m_batchingEnabled) {
+        sendSpeedData(sample);
+        return;
+    }
+    
+    bool wasEmpty = m_batcher.isEmpty();
+    if (m_batcher.add(sample)) {
+        flushBatch();
+    } else if (wasEmpty) {
+        m_batchTimer->start(m_batcher.maxLatency());
+    }
+}
+
+void SpeedReportingService::flushBatch()
+{
+    m_batchTimer->stop();
+    if (m_batcher.isEmpty()) {
+        return;
+    }
+    
+    if (m_qos > 0 || isReporting()) {
+        publishSamples(m_batchTopic, m_binaryBatchTopic, m_batcher.samples().constData(), m_batcher.size());
+    } else if (m_isReporting) {
+        for (const SpeedSample &sample : m_batcher.samples()) {
+            bufferOffline(sample);
         }
-        encoded.append(char(digit));
-    } while (length > 0);
-    return encoded;
+    }
+    m_batcher.clear();
+}
+
+void SpeedReportingService::setBatchingEnabled(bool enabled)
+{
+    if (!enabled) {
+        flushBatch();
+    }
+    m_batchingEnabled = enabled;
+}
+
+void SpeedReportingService::setPayloadFormat(TelemetryCodec::Format format)
+{
+    // Samples already batched go out in the format they were collected for
+    flushBatch();
+    m_payloadFormat = format;
+}
+
+void SpeedReportingService::setBatchLimits(int maxSamples, int maxLatencyMs)
+{
+    m_batcher.setMaxSamples(qMin(maxSamples, TelemetryCodec::MAX_SAMPLES));
+    m_batcher.setMaxLatency(maxLatencyMs);
+    if (m_batcher.isFull()) {
+        flushBatch();
+    }
+}
+
+void SpeedReportingService::setQos(int qos)
+{
+    flushBatch();
+    m_qos = qBound(0, qos, 1);
+}
+
+void SpeedReportingService::setInFlightWindow(int messages)
+{
+    m_inFlightWindow = qMax(1, messages);
+    pumpOutbox();
+}
+
+bool SpeedReportingService::setOutboxPath(const QString &path)
+{
+    // Sequences are renumbered when a log is loaded, so whatever was in
+    // flight is sent again under the new numbering
+    m_inFlight.clear();
+    m_lastSentSequence = 0;
+    
+    bool opened = m_outbox.open(path);
+    if (!opened) {
+        emit errorOccurred(QString("Cannot open outbox %1: %2").arg(path, m_outbox.errorString()));
+    }
+    pumpOutbox();
+    return opened;
 }
 
 void SpeedReportingService::setupReportingTimer()
@@ -155,149 +419,338 @@ void SpeedReportingService::setupReportingTimer()
     });
 }
 
-void SpeedReportingService::sendSpeedData(double speed)
+bool SpeedReportingService::isOnline() const
 {
-    if (!isReporting()) {
+    return isReporting() && m_isSubscribed;
+}
+
+void SpeedReportingService::setDrainRate(int samplesPerSecond)
+{
+    m_drainRate = qMax(1, samplesPerSecond);
+}
+
+void SpeedReportingService::bufferOffline(const SpeedSample &sample)
+{
+    if (m_offlineSamples.tryPush(sample)) {
+        ++m_offlineCount;
+        return;
+    }
+    
+    // Full: the oldest sample makes room
+    SpeedSample oldest;
+    m_offlineSamples.tryPop(oldest);
+    m_offlineSamples.tryPush(sample);
+    ++m_offlineDropped;
+}
+
+void SpeedReportingService::drainOffline()
+{
+    m_drainCredit += qint64(m_drainRate) * DRAIN_INTERVAL_MS;
+    SpeedSample sample;
+    while (m_drainCredit >= 1000 && isOnline() && m_offlineSamples.tryPop(sample)) {
+        --m_offlineCount;
+        m_drainCredit -= 1000;
+        submitSample(sample);
+    }
+    
+    if (m_offlineCount == 0 || !isOnline()) {
+        // Credit is not saved up across a pause into a burst later
+        m_drainCredit = 0;
+        m_drainTimer->stop();
+    }
+}
+
+void SpeedReportingService::clearOffline()
+{
+    SpeedSample sample;
+    while (m_offlineSamples.tryPop(sample)) {
+    }
+    m_offlineCount = 0;
+    m_drainCredit = 0;
+    m_drainTimer->stop();
+}
+
+void SpeedReportingService::sendSpeedData(const SpeedSample &sample)
+{
+    if (m_payloadFormat == TelemetryCodec::Format::Binary) {
+        publishSamples(m_publishTopic, m_binaryPublishTopic, &sample, 1);
+        return;
+    }
+    
+    QByteArray message = formatSpeedMessage(sample);
+    publishTelemetry(m_publishTopic, message);  // Publish to different topic
+    emit speedReported(QString::fromUtf8(m_publishTopic), QString::fromUtf8(message));
+}
+
+void SpeedReportingService::publishSamples(const QByteArray &jsonTopic, const QByteArray &binaryTopic,
+                                           const SpeedSample *samples, int count)
+{
+    if (m_payloadFormat == TelemetryCodec::Format::Json) {
+        QByteArray message = formatBatchMessage(samples, count);
+        publishTelemetry(jsonTopic, message);
+        emit speedReported(QString::fromUtf8(jsonTopic), QString::fromUtf8(message));
+        return;
+    }
+    
+    // Binary records are not readable text, so the UI gets a summary
+    int size = TelemetryCodec::encodeBinary(samples, count, m_binaryPayload);
+    publishTelemetry(binaryTopic, m_binaryPayload);
+    emit speedReported(QString::fromUtf8(binaryTopic),
+                       QString("%1 samples, %2 bytes binary v%3").arg(count).arg(size).arg(TelemetryCodec::BINARY_VERSION));
+}
+
+void SpeedReportingService::publishTelemetry(const QByteArray &topic, const QByteArray &payload)
+{
+    if (m_qos == 0) {
+        if (isReporting()) {
+            sendMqttPublish(topic, payload);
+        }
+        return;
+    }
+    
+    m_outbox.enqueue(topic, payload);
+    pumpOutbox();
+}
+
+void SpeedReportingService::pumpOutbox()
+{
+    if (m_connectionState != Online || !isReporting()) {
         return;
     }
     
-    QString message = formatSpeedMessage(speed);
-    sendMqttPublish("vehicle/speed/publish", message);  // Publish to different topic
-    emit speedReported("vehicle/speed/publish", message);
+    // Keep the window full instead of waiting out one round trip per message
+    while (m_inFlight.size() < m_inFlightWindow) {
+        MqttOutbox::Message *message = m_outbox.nextAfter(m_lastSentSequence);
+        if (!message) {
+            break;
+        }
+        
+        quint16 packetId = nextPacketId();
+        m_encoder.encodePublish(message->topic, message->payload, 1, packetId, false, message->attempts > 0);
+        
+        MQTT_TRACE_PACKET(">>", m_encoder.data(), m_encoder.size());
+        m_socket->write(m_encoder.data(), m_encoder.size());
+        ++message->attempts;
+        m_inFlight.insert(packetId, message->sequence);
+        m_lastSentSequence = message->sequence;
+    }
+}
+
+quint16 SpeedReportingService::nextPacketId()
+{
+    // Never 0, and never an id still waiting for its PUBACK
+    do {
+        m_packetId = m_packetId % 0xFFFF + 1;
+    } while (m_inFlight.contains(quint16(m_packetId)));
+    return quint16(m_packetId);
+}
+
+QByteArray SpeedReportingService::formatSpeedMessage(double speed) const
+{
+    return formatSpeedMessage({ SpeedSample::PLAYER_VEHICLE, QDateTime::currentMSecsSinceEpoch(), speed });
+}
+
+QByteArray SpeedReportingService::formatSpeedMessage(const SpeedSample &sample) const
+{
+    QJsonObject jsonObj;
+    jsonObj["timestamp"] = QDateTime::fromMSecsSinceEpoch(sample.timestamp).toString(Qt::ISODate);
+    jsonObj["speed"] = sample.speed;
+    jsonObj["unit"] = "km/h";
+    jsonObj["threshold_exceeded"] = sample.speed >= m_speedThreshold;
+    jsonObj["vehicle_id"] = vehicleName(sample.vehicleId);
+    
+    QJsonDocument doc(jsonObj);
+    return doc.toJson(QJsonDocument::Compact);
 }
 
-QString SpeedReportingService::formatSpeedMessage(double speed)
+QByteArray SpeedReportingService::formatBatchMessage(const SpeedSample *samples, int count) const
 {
+    // Shared fields once per batch; timestamps as epoch milliseconds
+    QJsonArray entries;
+    for (int i = 0; i < count; ++i) {
+        const SpeedSample &sample = samples[i];
+        QJsonObject entry;
+        entry["vehicle_id"] = vehicleName(sample.vehicleId);
+        entry["timestamp"] = sample.timestamp;
+        entry["speed"] = sample.speed;
+        entry["threshold_exceeded"] = sample.speed >= m_speedThreshold;
+        entries.append(entry);
+    }
+    
     QJsonObject jsonObj;
-    jsonObj["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    jsonObj["speed"] = speed;
     jsonObj["unit"] = "km/h";
-    jsonObj["threshold_exceeded"] = true;
-    jsonObj["vehicle_id"] = m_clientId;
+    jsonObj["samples"] = entries;
     
     QJsonDocument doc(jsonObj);
     return doc.toJson(QJsonDocument::Compact);
 }
 
+QString SpeedReportingService::vehicleName(qint32 vehicleId) const
+{
+    if (vehicleId == SpeedSample::PLAYER_VEHICLE) {
+        return m_clientId;
+    }
+    return QString("%1/fleet/%2").arg(m_clientId).arg(vehicleId);
+}
+
 void SpeedReportingService::sendMqttConnect()
 {
-    QByteArray connectPacket;
-    
-    // Fixed header
-    connectPacket.append(char(0x10)); // CONNECT packet type
-    
-    // Variable header
-    QByteArray protocolName = "MQTT";
-    QByteArray variableHeader;
-    variableHeader.append(char(0x00)); // Protocol name length MSB
-    variableHeader.append(char(0x04)); // Protocol name length LSB
-    variableHeader.append(protocolName);
-    variableHeader.append(char(0x04)); // Protocol level
-    variableHeader.append(char(0x02)); // Connect flags (clean session)
-    variableHeader.append(char(0x00)); // Keep alive MSB
-    variableHeader.append(char(0x3C)); // Keep alive LSB (60 seconds)
-    
-    // Payload
-    QByteArray clientIdBytes = m_clientId.toUtf8();
-    QByteArray payload;
-    payload.append(char(clientIdBytes.size() >> 8)); // Client ID length MSB
-    payload.append(char(clientIdBytes.size() & 0xFF)); // Client ID length LSB
-    payload.append(clientIdBytes);
-    
-    // Calculate remaining length and encode it
-    int remainingLength = variableHeader.size() + payload.size();
-    QByteArray encodedLength = encodeRemainingLength(remainingLength);
-    connectPacket.append(encodedLength);
-    connectPacket.append(variableHeader);
-    connectPacket.append(payload);
-    
-    qDebug() << "Sending MQTT CONNECT packet, size:" << connectPacket.size() << "remaining length:" << remainingLength;
-    qDebug() << "CONNECT packet hex:" << connectPacket.toHex();
-    m_socket->write(connectPacket);
-}
-
-void SpeedReportingService::sendMqttPublish(const QString &topic, const QString &message)
-{
-    QByteArray publishPacket;
-    
-    // Fixed header
-    publishPacket.append(char(0x30)); // PUBLISH packet type
-    
-    // Variable header
-    QByteArray topicBytes = topic.toUtf8();
-    QByteArray variableHeader;
-    variableHeader.append(char(topicBytes.size() >> 8)); // Topic length MSB
-    variableHeader.append(char(topicBytes.size() & 0xFF)); // Topic length LSB
-    variableHeader.append(topicBytes);
-    
-    // Payload
-    QByteArray messageBytes = message.toUtf8();
-    
-    // Calculate remaining length and encode it
-    int remainingLength = variableHeader.size() + messageBytes.size();
-    QByteArray encodedLength = encodeRemainingLength(remainingLength);
-    publishPacket.append(encodedLength);
-    publishPacket.append(variableHeader);
-    publishPacket.append(messageBytes);
-    
-    qDebug() << "Sending MQTT PUBLISH packet to topic:" << topic << "size:" << publishPacket.size() << "remaining length:" << remainingLength;
-    qDebug() << "PUBLISH packet hex:" << publishPacket.toHex();
-    m_socket->write(publishPacket);
-}
-
-void SpeedReportingService::sendMqttSubscribe(const QString &topic)
-{
-    QByteArray subscribePacket;
-    
-    // Fixed header
-    subscribePacket.append(char(0x82)); // SUBSCRIBE packet type
-    
-    // Variable header
-    QByteArray variableHeader;
-    variableHeader.append(char(m_packetId >> 8)); // Packet ID MSB
-    variableHeader.append(char(m_packetId & 0xFF)); // Packet ID LSB
-    
-    // Payload
-    QByteArray topicBytes = topic.toUtf8();
-    QByteArray payload;
-    payload.append(char(topicBytes.size() >> 8)); // Topic length MSB
-    payload.append(char(topicBytes.size() & 0xFF)); // Topic length LSB
-    payload.append(topicBytes);
-    payload.append(char(0x00)); // QoS level
-    
-    // Calculate remaining length and encode it
-    int remainingLength = variableHeader.size() + payload.size();
-    QByteArray encodedLength = encodeRemainingLength(remainingLength);
-    subscribePacket.append(encodedLength);
-    subscribePacket.append(variableHeader);
-    subscribePacket.append(payload);
-    
-    qDebug() << "Sending MQTT SUBSCRIBE packet to topic:" << topic << "size:" << subscribePacket.size();
-    qDebug() << "SUBSCRIBE packet hex:" << subscribePacket.toHex();
-    qDebug() << "Remaining length:" << remainingLength << "Encoded length:" << encodedLength.toHex();
-    qDebug() << "Variable header size:" << variableHeader.size() << "Payload size:" << payload.size();
-    qDebug() << "Packet ID:" << m_packetId;
-    m_socket->write(subscribePacket);
-    m_packetId++; // Increment for next packet
+    m_encoder.encodeConnect(m_clientIdBytes, 60);
+    
+    MQTT_TRACE_PACKET(">>", m_encoder.data(), m_encoder.size());
+    m_socket->write(m_encoder.data(), m_encoder.size());
+}
+
+void SpeedReportingService::sendMqttPublish(const QByteArray &topic, const QByteArray &message)
+{
+    m_encoder.encodePublish(topic, message);
+    
+    MQTT_TRACE_PACKET(">>", m_encoder.data(), m_encoder.size());
+    m_socket->write(m_encoder.data(), m_encoder.size());
+}
+
+void SpeedReportingService::sendMqttSubscribe(const QByteArray &topic)
+{
+    quint16 packetId = nextPacketId();
+    m_encoder.encodeSubscribe(packetId, topic);
+    
+    qDebug() << "Subscribing to" << topic << "packet ID:" << packetId;
+    MQTT_TRACE_PACKET(">>", m_encoder.data(), m_encoder.size());
+    m_socket->write(m_encoder.data(), m_encoder.size());
 }
 
 void SpeedReportingService::sendMqttPingReq()
 {
-    QByteArray pingPacket;
-    pingPacket.append(char(0xC0)); // PINGREQ packet type
-    pingPacket.append(char(0x00)); // Remaining length (0)
+    m_encoder.encodePingReq();
     
-    qDebug() << "Sending MQTT PINGREQ packet";
-    qDebug() << "PINGREQ packet hex:" << pingPacket.toHex();
-    m_socket->write(pingPacket);
+    MQTT_TRACE_PACKET(">>", m_encoder.data(), m_encoder.size());
+    m_socket->write(m_encoder.data(), m_encoder.size());
+}
+
+void SpeedReportingService::readMqttFrames()
+{
+    // Read straight into the decoder; one read may hold several packets or
+    // only part of one, and the decoder reassembles either case.
+    qint64 available = m_socket->bytesAvailable();
+    while (available > 0) {
+        int chunk = int(qMin<qint64>(available, 64 * 1024));
+        qint64 received = m_socket->read(m_decoder.prepareWrite(chunk), chunk);
+        if (received <= 0) {
+            break;
+        }
+        m_decoder.commitWrite(int(received));
+        
+        MqttFrame frame;
+        MqttFrameDecoder::Status status;
+        while ((status = m_decoder.next(frame)) == MqttFrameDecoder::FrameReady) {
+            MQTT_TRACE_PACKET("<<", frame);
+            handleMqttFrame(frame);
+        }
+        
+        if (status == MqttFrameDecoder::Malformed) {
+            QString errorMsg = QString("Protocol error: %1").arg(m_decoder.errorString());
+            qDebug() << errorMsg;
+            emit errorOccurred(errorMsg);
+            m_socket->abort();
+            return;
+        }
+        
+        available = m_socket->bytesAvailable();
+    }
 }
 
-void SpeedReportingService::handleMqttMessage(const QByteArray &packet)
+void SpeedReportingService::handleMqttFrame(const MqttFrame &frame)
 {
-    // Simple logging for now - don't parse the packet
-    qDebug() << "PUBLISH packet received, size:" << packet.size();
-    qDebug() << "Packet hex:" << packet.toHex();
+    switch (frame.type()) {
+    case MqttFrame::Connack:
+        if (frame.bodySize < 2 || frame.body[1] != 0) {
+            QString errorMsg = QString("Broker refused connection, return code %1")
+                                   .arg(frame.bodySize < 2 ? -1 : int(quint8(frame.body[1])));
+            qDebug() << errorMsg;
+            emit errorOccurred(errorMsg);
+            m_socket->disconnectFromHost();
+            return;
+        }
+        
+        qDebug() << "CONNACK received - connection successful!";
+        emit reportingStatusChanged(true);
+        
+        // Subscribe to the topic for forwarding
+        QTimer::singleShot(500, this, [this]() {
+            sendMqttSubscribe(m_alertTopic);
+        });
+        
+        // Start keep-alive timer
+        m_reportingTimer->start();
+        
+        // A clean session forgets in-flight packet ids, so everything not
+        // acknowledged goes out again, flagged as a duplicate if sent before
+        m_connectionState = Online;
+        m_reconnectAttempts = 0;
+        m_inFlight.clear();
+        m_lastSentSequence = 0;
+        pumpOutbox();
+        break;
+        
+    case MqttFrame::Suback:
+        qDebug() << "SUBACK received - subscription successful!";
+        m_isSubscribed = true;
+        if (m_offlineCount > 0) {
+            m_drainTimer->start();
+        }
+        
+        // Send a test PUBLISH packet to keep connection alive
+        QTimer::singleShot(200, this, [this]() {
+            qDebug() << "Sending test PUBLISH packet to keep connection alive";
+            sendMqttPublish(m_publishTopic, "{\"test\": \"connection_keepalive\"}");
+        });
+        break;
+        
+    case MqttFrame::Puback:
+        handlePubAck(frame);
+        break;
+        
+    case MqttFrame::Pingresp:
+        // Keep-alive answered; nothing else to do
+        break;
+        
+    case MqttFrame::Publish: {
+        MqttPublish publish;
+        if (MqttFrameDecoder::decodePublish(frame, publish)) {
+            handleMqttMessage(publish);
+        } else {
+            qDebug() << "Ignoring malformed PUBLISH packet, size:" << frame.bodySize;
+        }
+        break;
+    }
+        
+    default:
+        qDebug() << "Ignoring MQTT packet type" << frame.type();
+        break;
+    }
+}
+
+void SpeedReportingService::handlePubAck(const MqttFrame &frame)
+{
+    if (frame.bodySize < 2) {
+        qDebug() << "Ignoring PUBACK without a packet ID";
+        return;
+    }
     
-    // Just acknowledge receipt without parsing
-    qDebug() << "Message received on vehicle/speed/alert topic";
-} 
\ No newline at end of file
+    quint16 packetId = quint16((quint8(frame.body[0]) << 8) | quint8(frame.body[1]));
+    auto it = m_inFlight.find(packetId);
+    if (it == m_inFlight.end()) {
+        // Duplicate acknowledgement, or not a packet we sent
+        return;
+    }
+    
+    m_outbox.acknowledge(it.value());
+    m_inFlight.erase(it);
+    pumpOutbox();
+}
+
+void SpeedReportingService::handleMqttMessage(const MqttPublish &publish)
+{
+    // Nothing consumes inbound messages yet; they are visible in the wire trace
+    Q_UNUSED(publish);
+}
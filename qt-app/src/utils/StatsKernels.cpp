@@ -0,0 +1,344 @@
+#include "utils/StatsKernels.h"
+#include "core/FleetKernels.h"
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STATS_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define STATS_TARGET(isa)
+#else
+#define STATS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace StatsKernels
+{
+
+// Kahan summation: sum - compensation is the total to about one rounding
+struct Compensated {
+    double sum;
+    double compensation;
+    
+    void add(double value)
+    {
+        double y = value - compensation;
+        double t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+    
+    double total() const { return sum - compensation; }
+};
+
+struct MomentSums {
+    Compensated sum;
+    Compensated squares;
+    double minValue;
+    double maxValue;
+};
+
+struct CrossSums {
+    Compensated x;
+    Compensated y;
+    Compensated xx;
+    Compensated yy;
+    Compensated xy;
+};
+
+// Scalar reference, also used for the vector paths' tails. The min and max
+// comparisons are written the way MINPD/MAXPD evaluate them.
+static void accumulateScalar(const double *data, qint64 first, qint64 count, double shift, MomentSums &sums)
+{
+    for (qint64 i = first; i < count; ++i) {
+        double value = data[i];
+        double delta = value - shift;
+        sums.sum.add(delta);
+        sums.squares.add(delta * delta);
+        sums.minValue = value < sums.minValue ? value : sums.minValue;
+        sums.maxValue = value > sums.maxValue ? value : sums.maxValue;
+    }
+}
+
+static void accumulateScalar(const double *x, const double *y, qint64 first, qint64 count,
+                             double shiftX, double shiftY, CrossSums &sums)
+{
+    for (qint64 i = first; i < count; ++i) {
+        double dx = x[i] - shiftX;
+        double dy = y[i] - shiftY;
+        sums.x.add(dx);
+        sums.y.add(dy);
+        sums.xx.add(dx * dx);
+        sums.yy.add(dy * dy);
+        sums.xy.add(dx * dy);
+    }
+}
+
+#ifdef STATS_KERNELS_X86
+
+STATS_TARGET("avx2")
+static inline void addCompensated(__m256d &sum, __m256d &compensation, __m256d value)
+{
+    __m256d y = _mm256_sub_pd(value, compensation);
+    __m256d t = _mm256_add_pd(sum, y);
+    compensation = _mm256_sub_pd(_mm256_sub_pd(t, sum), y);
+    sum = t;
+}
+
+STATS_TARGET("avx2")
+static void foldLanes(Compensated &into, __m256d sum, __m256d compensation)
+{
+    double sums[4];
+    double compensations[4];
+    _mm256_storeu_pd(sums, sum);
+    _mm256_storeu_pd(compensations, compensation);
+    for (int lane = 0; lane < 4; ++lane) {
+        into.add(sums[lane]);
+        into.add(-compensations[lane]);
+    }
+}
+
+// Two independent sets of accumulators, so consecutive Kahan steps do not
+// wait on each other
+STATS_TARGET("avx2")
+static void accumulateAvx2(const double *data, qint64 count, double shift, MomentSums &sums)
+{
+    const __m256d shiftV = _mm256_set1_pd(shift);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d sumA = zero, sumCompA = zero, squaresA = zero, squaresCompA = zero;
+    __m256d sumB = zero, sumCompB = zero, squaresB = zero, squaresCompB = zero;
+    __m256d low = _mm256_set1_pd(sums.minValue);
+    __m256d high = _mm256_set1_pd(sums.maxValue);
+    
+    qint64 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(data + i);
+        __m256d b = _mm256_loadu_pd(data + i + 4);
+        __m256d deltaA = _mm256_sub_pd(a, shiftV);
+        __m256d deltaB = _mm256_sub_pd(b, shiftV);
+        addCompensated(sumA, sumCompA, deltaA);
+        addCompensated(sumB, sumCompB, deltaB);
+        addCompensated(squaresA, squaresCompA, _mm256_mul_pd(deltaA, deltaA));
+        addCompensated(squaresB, squaresCompB, _mm256_mul_pd(deltaB, deltaB));
+        low = _mm256_min_pd(b, _mm256_min_pd(a, low));
+        high = _mm256_max_pd(b, _mm256_max_pd(a, high));
+    }
+    
+    foldLanes(sums.sum, sumA, sumCompA);
+    foldLanes(sums.sum, sumB, sumCompB);
+    foldLanes(sums.squares, squaresA, squaresCompA);
+    foldLanes(sums.squares, squaresB, squaresCompB);
+    
+    double lows[4];
+    double highs[4];
+    _mm256_storeu_pd(lows, low);
+    _mm256_storeu_pd(highs, high);
+    for (int lane = 0; lane < 4; ++lane) {
+        sums.minValue = lows[lane] < sums.minValue ? lows[lane] : sums.minValue;
+        sums.maxValue = highs[lane] > sums.maxValue ? highs[lane] : sums.maxValue;
+    }
+    
+    accumulateScalar(data, i, count, shift, sums);
+}
+
+STATS_TARGET("avx2")
+static void accumulateAvx2(const double *x, const double *y, qint64 count,
+                           double shiftX, double shiftY, CrossSums &sums)
+{
+    const __m256d shiftXV = _mm256_set1_pd(shiftX);
+    const __m256d shiftYV = _mm256_set1_pd(shiftY);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d sumX = zero, sumXComp = zero, sumY = zero, sumYComp = zero;
+    __m256d sumXX = zero, sumXXComp = zero, sumYY = zero, sumYYComp = zero;
+    __m256d sumXY = zero, sumXYComp = zero;
+    
+    qint64 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), shiftXV);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), shiftYV);
+        addCompensated(sumX, sumXComp, dx);
+        addCompensated(sumY, sumYComp, dy);
+        addCompensated(sumXX, sumXXComp, _mm256_mul_pd(dx, dx));
+        addCompensated(sumYY, sumYYComp, _mm256_mul_pd(dy, dy));
+        addCompensated(sumXY, sumXYComp, _mm256_mul_pd(dx, dy));
+    }
+    
+    foldLanes(sums.x, sumX, sumXComp);
+    foldLanes(sums.y, sumY, sumYComp);
+    foldLanes(sums.xx, sumXX, sumXXComp);
+    foldLanes(sums.yy, sumYY, sumYYComp);
+    foldLanes(sums.xy, sumXY, sumXYComp);
+    
+    accumulateScalar(x, y, i, count, shiftX, shiftY, sums);
+}
+
+#endif
+
+bool isPathSupported(Path path)
+{
+    if (path == Path::Scalar) {
+        return true;
+    }
+    // Same CPU and OS checks as the fleet kernels
+    return FleetKernels::isPathSupported(FleetKernels::Path::Avx2);
+}
+
+Path bestSupportedPath()
+{
+    return isPathSupported(Path::Avx2) ? Path::Avx2 : Path::Scalar;
+}
+
+static std::atomic<int> s_activePath(-1);
+
+Path activePath()
+{
+    int path = s_activePath.load(std::memory_order_relaxed);
+    if (path < 0) {
+        path = int(bestSupportedPath());
+        s_activePath.store(path, std::memory_order_relaxed);
+    }
+    return Path(path);
+}
+
+void setActivePath(Path path)
+{
+    s_activePath.store(int(isPathSupported(path) ? path : bestSupportedPath()), std::memory_order_relaxed);
+}
+
+const char *pathName(Path path)
+{
+    return path == Path::Avx2 ? "avx2" : "scalar";
+}
+
+Moments moments(const double *data, qint64 count)
+{
+    return moments(activePath(), data, count);
+}
+
+Moments moments(Path path, const double *data, qint64 count)
+{
+    Moments result = {};
+    if (count <= 0) {
+        return result;
+    }
+    
+    MomentSums sums = {};
+    sums.minValue = data[0];
+    sums.maxValue = data[0];
+#ifdef STATS_KERNELS_X86
+    if (path == Path::Avx2 && isPathSupported(Path::Avx2)) {
+        accumulateAvx2(data, count, data[0], sums);
+    } else {
+        accumulateScalar(data, 0, count, data[0], sums);
+    }
+#else
+    (void)path;
+    accumulateScalar(data, 0, count, data[0], sums);
+#endif
+
+    result.count = count;
+    result.shift = data[0];
+    result.sum = sums.sum.total();
+    result.sumSquares = sums.squares.total();
+    result.minValue = sums.minValue;
+    result.maxValue = sums.maxValue;
+    return result;
+}
+
+CrossMoments crossMoments(const double *x, const double *y, qint64 count)
+{
+    return crossMoments(activePath(), x, y, count);
+}
+
+CrossMoments crossMoments(Path path, const double *x, const double *y, qint64 count)
+{
+    CrossMoments result = {};
+    if (count <= 0) {
+        return result;
+    }
+    
+    CrossSums sums = {};
+#ifdef STATS_KERNELS_X86
+    if (path == Path::Avx2 && isPathSupported(Path::Avx2)) {
+        accumulateAvx2(x, y, count, x[0], y[0], sums);
+    } else {
+        accumulateScalar(x, y, 0, count, x[0], y[0], sums);
+    }
+#else
+    (void)path;
+    accumulateScalar(x, y, 0, count, x[0], y[0], sums);
+#endif
+
+    result.count = count;
+    result.shiftX = x[0];
+    result.shiftY = y[0];
+    result.sumX = sums.x.total();
+    result.sumY = sums.y.total();
+    result.sumXX = sums.xx.total();
+    result.sumYY = sums.yy.total();
+    result.sumXY = sums.xy.total();
+    return result;
+}
+
+Moments combine(const Moments &a, const Moments &b)
+{
+    if (a.count == 0) {
+        return b;
+    }
+    if (b.count == 0) {
+        return a;
+    }
+    
+    // Re-centre b's sums on a's shift
+    double delta = b.shift - a.shift;
+    Moments result = a;
+    result.count = a.count + b.count;
+    result.sum = a.sum + b.sum + b.count * delta;
+    result.sumSquares = a.sumSquares + b.sumSquares + 2.0 * delta * b.sum + b.count * delta * delta;
+    result.minValue = b.minValue < a.minValue ? b.minValue : a.minValue;
+    result.maxValue = b.maxValue > a.maxValue ? b.maxValue : a.maxValue;
+    return result;
+}
+
+double mean(const Moments &moments)
+{
+    return moments.count > 0 ? moments.shift + moments.sum / moments.count : 0.0;
+}
+
+double variance(const Moments &moments)
+{
+    if (moments.count < 2) {
+        return 0.0;
+    }
+    double squares = moments.sumSquares - moments.sum * moments.sum / moments.count;
+    return squares > 0.0 ? squares / (moments.count - 1) : 0.0;
+}
+
+double rawSum(const Moments &moments)
+{
+    return moments.shift * moments.count + moments.sum;
+}
+
+double rawSumSquares(const Moments &moments)
+{
+    return moments.sumSquares + 2.0 * moments.shift * moments.sum
+        + moments.shift * moments.shift * moments.count;
+}
+
+double correlation(const CrossMoments &moments)
+{
+    if (moments.count < 2) {
+        return 0.0;
+    }
+    double n = double(moments.count);
+    double covariance = moments.sumXY - moments.sumX * moments.sumY / n;
+    double varianceX = moments.sumXX - moments.sumX * moments.sumX / n;
+    double varianceY = moments.sumYY - moments.sumY * moments.sumY / n;
+    if (varianceX <= 0.0 || varianceY <= 0.0) {
+        return 0.0;
+    }
+    return covariance / std::sqrt(varianceX * varianceY);
+}
+
+}
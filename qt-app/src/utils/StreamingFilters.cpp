@@ -0,0 +1,185 @@
+#include "utils/StreamingFilters.h"
+#include <cmath>
+#include <iterator>
+
+StreamingMovingAverage::StreamingMovingAverage(int windowSize)
+    : m_window(qMax(1, windowSize))
+    , m_next(0)
+    , m_count(0)
+    , m_sum(0.0)
+{
+}
+
+double StreamingMovingAverage::push(double value)
+{
+    if (!std::isfinite(value)) {
+        return value;
+    }
+    
+    if (m_count == m_window.size()) {
+        m_sum -= m_window[m_next];
+    } else {
+        ++m_count;
+    }
+    m_window[m_next] = value;
+    m_sum += value;
+    
+    m_next = (m_next + 1) % int(m_window.size());
+    if (m_next == 0) {
+        // Once per window length, so still O(1) per sample
+        m_sum = 0.0;
+        for (double sample : m_window) {
+            m_sum += sample;
+        }
+    }
+    return m_sum / m_count;
+}
+
+void StreamingMovingAverage::reset()
+{
+    m_next = 0;
+    m_count = 0;
+    m_sum = 0.0;
+}
+
+StreamingMedian::StreamingMedian(int windowSize)
+    : m_window(qMax(1, windowSize))
+    , m_next(0)
+    , m_count(0)
+{
+}
+
+double StreamingMedian::push(double value)
+{
+    if (!std::isfinite(value)) {
+        return value;
+    }
+    
+    // Inserting before removing keeps the lower half non-empty, so the
+    // ordering between the halves holds until rebalance() evens them out
+    if (m_lower.empty() || value <= *m_lower.rbegin()) {
+        m_lower.insert(value);
+    } else {
+        m_upper.insert(value);
+    }
+    
+    if (m_count == m_window.size()) {
+        // Every upper value is >= the lower maximum, so anything up to it
+        // is in the lower half; an equal value may be removed from either
+        double expired = m_window[m_next];
+        if (expired <= *m_lower.rbegin()) {
+            m_lower.erase(m_lower.find(expired));
+        } else {
+            m_upper.erase(m_upper.find(expired));
+        }
+    } else {
+        ++m_count;
+    }
+    m_window[m_next] = value;
+    m_next = (m_next + 1) % int(m_window.size());
+    rebalance();
+    
+    if (m_lower.size() > m_upper.size()) {
+        return *m_lower.rbegin();
+    }
+    return (*m_lower.rbegin() + *m_upper.begin()) / 2.0;
+}
+
+void StreamingMedian::reset()
+{
+    m_next = 0;
+    m_count = 0;
+    m_lower.clear();
+    m_upper.clear();
+}
+
+void StreamingMedian::rebalance()
+{
+    // The lower half holds the extra sample when the count is odd
+    while (m_lower.size() > m_upper.size() + 1) {
+        auto largest = std::prev(m_lower.end());
+        m_upper.insert(*largest);
+        m_lower.erase(largest);
+    }
+    while (m_upper.size() > m_lower.size()) {
+        auto smallest = m_upper.begin();
+        m_lower.insert(*smallest);
+        m_upper.erase(smallest);
+    }
+}
+
+StreamingGaussian::StreamingGaussian(double sigma)
+    : m_next(0)
+    , m_count(0)
+{
+    sigma = sigma > 0.0 ? sigma : 1.0;
+    int radius = qMax(1, int(std::ceil(sigma * 3.0)));
+    m_weights.resize(radius + 1);
+    for (int offset = 0; offset <= radius; ++offset) {
+        m_weights[offset] = std::exp(-(offset * offset) / (2.0 * sigma * sigma));
+    }
+    m_history.resize(radius + 1);
+}
+
+double StreamingGaussian::push(double value)
+{
+    if (!std::isfinite(value)) {
+        return value;
+    }
+    
+    int size = int(m_history.size());
+    m_history[m_next] = value;
+    m_next = (m_next + 1) % size;
+    m_count = qMin(m_count + 1, size);
+    
+    // Offset 0 is the sample just pushed
+    double sum = 0.0;
+    double weightSum = 0.0;
+    int index = m_next;
+    for (int offset = 0; offset < m_count; ++offset) {
+        index = index == 0 ? size - 1 : index - 1;
+        sum += m_history[index] * m_weights[offset];
+        weightSum += m_weights[offset];
+    }
+    return sum / weightSum;
+}
+
+void StreamingGaussian::reset()
+{
+    m_next = 0;
+    m_count = 0;
+}
+
+StreamingKalman::StreamingKalman(double processNoise, double measurementNoise)
+    : m_processNoise(processNoise)
+    , m_measurementNoise(measurementNoise)
+    , m_estimate(0.0)
+    , m_errorCovariance(1.0)
+    , m_initialized(false)
+{
+}
+
+double StreamingKalman::push(double value)
+{
+    if (!std::isfinite(value)) {
+        return value;
+    }
+    
+    if (!m_initialized) {
+        m_estimate = value;
+        m_initialized = true;
+    }
+    
+    m_errorCovariance += m_processNoise;
+    double gain = m_errorCovariance / (m_errorCovariance + m_measurementNoise);
+    m_estimate += gain * (value - m_estimate);
+    m_errorCovariance *= (1.0 - gain);
+    return m_estimate;
+}
+
+void StreamingKalman::reset()
+{
+    m_estimate = 0.0;
+    m_errorCovariance = 1.0;
+    m_initialized = false;
+}
@@ -0,0 +1,36 @@
+#include "utils/TelemetryBatcher.h"
+
+// 64 JSON samples stay well under a 4 KB PUBLISH; 250 ms keeps a dashboard
+// feeling live
+const int TelemetryBatcher::DEFAULT_MAX_SAMPLES = 64;
+const int TelemetryBatcher::DEFAULT_MAX_LATENCY_MS = 250;
+
+TelemetryBatcher::TelemetryBatcher(int maxSamples, int maxLatencyMs)
+    : m_maxSamples(qMax(1, maxSamples))
+    , m_maxLatencyMs(qMax(0, maxLatencyMs))
+{
+    m_samples.reserve(m_maxSamples);
+}
+
+void TelemetryBatcher::setMaxSamples(int maxSamples)
+{
+    m_maxSamples = qMax(1, maxSamples);
+    m_samples.reserve(m_maxSamples);
+}
+
+void TelemetryBatcher::setMaxLatency(int milliseconds)
+{
+    m_maxLatencyMs = qMax(0, milliseconds);
+}
+
+bool TelemetryBatcher::add(const SpeedSample &sample)
+{
+    m_samples.append(sample);
+    return isFull();
+}
+
+void TelemetryBatcher::clear()
+{
+    // Keeps the capacity, so a steady stream of batches does not reallocate
+    m_samples.resize(0);
+}
@@ -0,0 +1,79 @@
+#include "utils/TelemetryCodec.h"
+#include <QtEndian>
+#include <limits>
+
+namespace TelemetryCodec {
+
+const char BINARY_TOPIC_SUFFIX[] = "/bin/v1";
+
+QByteArray topicFor(const QByteArray &jsonTopic, Format format)
+{
+    if (format == Format::Binary) {
+        return jsonTopic + QByteArray(BINARY_TOPIC_SUFFIX);
+    }
+    return jsonTopic;
+}
+
+int encodeBinary(const SpeedSample *samples, int count, QByteArray &out)
+{
+    // Writes over out in place; resizing keeps the capacity, so a reused
+    // buffer stops allocating once it has held the largest batch
+    count = qBound(0, count, MAX_SAMPLES);
+    int size = HEADER_SIZE + count * RECORD_SIZE;
+    if (out.size() < size) {
+        out.resize(size);
+    }
+    uchar *data = reinterpret_cast<uchar *>(out.data());
+
+    qint64 baseTimestamp = count > 0 ? samples[0].timestamp : 0;
+    data[0] = BINARY_VERSION;
+    data[1] = 0;
+    qToLittleEndian<quint16>(quint16(count), data + 2);
+    qToLittleEndian<qint64>(baseTimestamp, data + 4);
+
+    uchar *record = data + HEADER_SIZE;
+    for (int i = 0; i < count; ++i) {
+        qint64 delta = qBound<qint64>(std::numeric_limits<qint32>::min(), samples[i].timestamp - baseTimestamp,
+                                      std::numeric_limits<qint32>::max());
+        qToLittleEndian<qint32>(samples[i].vehicleId, record);
+        qToLittleEndian<qint32>(qint32(delta), record + 4);
+        qToLittleEndian<float>(float(samples[i].speed), record + 8);
+        record += RECORD_SIZE;
+    }
+
+    out.resize(size);
+    return size;
+}
+
+bool decodeBinary(const char *data, int size, QVector<SpeedSample> &samples)
+{
+    samples.resize(0);
+    if (size < HEADER_SIZE) {
+        return false;
+    }
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(data);
+    if (bytes[0] != BINARY_VERSION) {
+        return false;
+    }
+
+    int count = qFromLittleEndian<quint16>(bytes + 2);
+    if (size != HEADER_SIZE + count * RECORD_SIZE) {
+        return false;
+    }
+
+    qint64 baseTimestamp = qFromLittleEndian<qint64>(bytes + 4);
+    samples.reserve(count);
+    const uchar *record = bytes + HEADER_SIZE;
+    for (int i = 0; i < count; ++i) {
+        SpeedSample sample;
+        sample.vehicleId = qFromLittleEndian<qint32>(record);
+        sample.timestamp = baseTimestamp + qFromLittleEndian<qint32>(record + 4);
+        sample.speed = qFromLittleEndian<float>(record + 8);
+        samples.append(sample);
+        record += RECORD_SIZE;
+    }
+    return true;
+}
+
+}
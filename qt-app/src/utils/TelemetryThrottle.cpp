@@ -0,0 +1,109 @@
+#include "utils/TelemetryThrottle.h"
+#include <limits>
+
+// The old service-wide filter: changes of a km/h or less are not news
+const double TelemetryThrottle::DEFAULT_DEADBAND = 1.0;
+
+// Ids beyond this are passed through untracked rather than growing the table
+const int TelemetryThrottle::MAX_TRACKED_VEHICLES = 1 << 20;
+
+TelemetryThrottle::TelemetryThrottle(double deadband, int minIntervalMs, double maxRate, int burst)
+    : m_deadband(qMax(0.0, deadband))
+    , m_minIntervalMs(qMax(0, minIntervalMs))
+    , m_maxRate(qMax(0.0, maxRate))
+    , m_burst(qMax(1, burst))
+    , m_alertThreshold(std::numeric_limits<double>::infinity())
+    , m_suppressed(0)
+    , m_alerts(0)
+{
+}
+
+void TelemetryThrottle::setDeadband(double kmh)
+{
+    m_deadband = qMax(0.0, kmh);
+}
+
+void TelemetryThrottle::setMinInterval(int milliseconds)
+{
+    m_minIntervalMs = qMax(0, milliseconds);
+}
+
+void TelemetryThrottle::setMaxRate(double perSecond, int burst)
+{
+    m_maxRate = qMax(0.0, perSecond);
+    m_burst = qMax(1, burst);
+    for (VehicleState &state : m_vehicles) {
+        state.tokens = qMin(state.tokens, double(m_burst));
+    }
+}
+
+TelemetryThrottle::Verdict TelemetryThrottle::admit(const SpeedSample &sample)
+{
+    VehicleState *state = stateFor(sample.vehicleId);
+    if (!state) {
+        return Admitted;
+    }
+    
+    bool above = sample.speed >= m_alertThreshold;
+    bool crossed = above && !state->aboveThreshold;
+    state->aboveThreshold = above;
+    
+    if (crossed) {
+        ++m_alerts;
+    } else {
+        if (state->published) {
+            qint64 sincePublished = sample.timestamp - state->lastPublished;
+            if (qAbs(sample.speed - state->lastSpeed) <= m_deadband
+                || (sincePublished >= 0 && sincePublished < m_minIntervalMs)) {
+                ++m_suppressed;
+                return Suppressed;
+            }
+        }
+    
+        if (m_maxRate > 0.0) {
+            // Clock steps backwards refill nothing
+            qint64 elapsed = qMax<qint64>(0, sample.timestamp - state->lastRefill);
+            state->tokens = qMin(double(m_burst), state->tokens + elapsed * m_maxRate / 1000.0);
+            state->lastRefill = sample.timestamp;
+            if (state->tokens < 1.0) {
+                ++m_suppressed;
+                return Suppressed;
+            }
+            state->tokens -= 1.0;
+        }
+    }
+    
+    state->lastSpeed = sample.speed;
+    state->lastPublished = sample.timestamp;
+    state->published = true;
+    return crossed ? Alert : Admitted;
+}
+
+void TelemetryThrottle::observe(const SpeedSample &sample)
+{
+    if (VehicleState *state = stateFor(sample.vehicleId)) {
+        state->aboveThreshold = sample.speed >= m_alertThreshold;
+    }
+}
+
+void TelemetryThrottle::clear()
+{
+    m_vehicles.clear();
+    m_suppressed = 0;
+    m_alerts = 0;
+}
+
+TelemetryThrottle::VehicleState *TelemetryThrottle::stateFor(qint32 vehicleId)
+{
+    qint64 index = qint64(vehicleId) + 1;
+    if (index < 0 || index >= MAX_TRACKED_VEHICLES) {
+        return nullptr;
+    }
+    
+    // New entries are zeroed: nothing published yet, and the first refill,
+    // from time 0, fills the bucket
+    if (index >= m_vehicles.size()) {
+        m_vehicles.resize(int(index) + 1);
+    }
+    return &m_vehicles[int(index)];
+}
@@ -34,6 +34,7 @@ ControlPanel::~ControlPanel()
 void ControlPanel::setGameEngine(GameEngine *engine)
 {
     m_gameEngine = engine;
+    m_snapshotCursor = GameEngine::SnapshotCursor();
 }
 
 void ControlPanel::setGameView(GameView *view)
@@ -109,7 +110,7 @@ void ControlPanel::onSpeedSliderChanged(int value)
     double speed = value / 100.0; 
     
     if (m_gameEngine && m_gameEngine->vehicle()) {
-        m_gameEngine->vehicle()->setSpeed(speed * 100.0); 
+        m_gameEngine->requestVehicleSpeed(speed * 100.0);
     }
     
     
@@ -125,14 +126,14 @@ void ControlPanel::onSpeedSliderChanged(int value)
 void ControlPanel::onAccelerateButtonClicked()
 {
     if (m_gameEngine && m_gameEngine->vehicle()) {
-        m_gameEngine->vehicle()->accelerate();
+        m_gameEngine->accelerateVehicle();
     }
 }
 
 void ControlPanel::onDecelerateButtonClicked()
 {
     if (m_gameEngine && m_gameEngine->vehicle()) {
-        m_gameEngine->vehicle()->decelerate();
+        m_gameEngine->decelerateVehicle();
     }
 }
 
@@ -150,8 +151,10 @@ void ControlPanel::updateSpeedTimer()
 {
     
     if (m_gameTimeLabel && m_gameEngine && m_gameEngine->isRunning()) {
-       
-        m_gameTimeLabel->setText("Game Running");
+        // Read whatever the engine thread published last, never the models
+        FrameSnapshot snapshot = m_gameEngine->latestSnapshot(m_snapshotCursor);
+        m_gameTimeLabel->setText(QString("Game Running: %1 s").arg(snapshot.simulationTime, 0, 'f', 1));
+        setSpeed(snapshot.vehicleSpeed);
     }
 }
 
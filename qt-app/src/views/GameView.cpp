@@ -203,6 +203,7 @@ void GameView::setGameEngine(GameEngine *engine)
 {
     if (m_gameEngine != engine) {
         m_gameEngine = engine;
+        m_snapshotCursor = GameEngine::SnapshotCursor();
         onGameEngineChanged();
     }
 }
@@ -248,6 +249,10 @@ void GameView::animateCar()
         return;
     }
     
+    if (m_gameEngine) {
+        updateCarPosition(m_gameEngine->latestSnapshot(m_snapshotCursor));
+    }
+    
     
     m_carProgress += 0.02 * m_carSpeed; 
     
@@ -347,21 +352,14 @@ void GameView::updateCarRotation()
 
 void GameView::onGameEngineChanged()
 {
-    if (m_gameEngine) {
-     
-        
-       
-        if (m_gameEngine->vehicle()) {
-            connect(m_gameEngine->vehicle(), &VehicleModel::positionChanged,
-                    this, &GameView::updateCarPosition);
-        }
-    }
+    // Nothing to connect: animateCar() pulls the latest engine snapshot
+    // each time the view redraws.
 }
 
-void GameView::updateCarPosition()
+void GameView::updateCarPosition(const FrameSnapshot &snapshot)
 {
-    if (m_gameEngine && m_gameEngine->vehicle()) {
-        QPointF vehiclePos = m_gameEngine->vehicle()->position();
+    if (snapshot.hasChanged(FrameSnapshot::VehiclePositionChanged)) {
+        QPointF vehiclePos = snapshot.vehiclePosition;
        
     }
 }
@@ -0,0 +1,186 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include "utils/LocalMqttBroker.h"
+#include "utils/SpeedReportingService.h"
+#include "utils/TelemetryCodec.h"
+
+namespace {
+
+double percentileMicros(const QVector<qint64> &sorted, double percentile)
+{
+    if (sorted.isEmpty()) {
+        return 0.0;
+    }
+    // Nearest rank
+    int rank = qBound(1, int(std::ceil(percentile / 100.0 * sorted.size())), int(sorted.size()));
+    return sorted[rank - 1] / 1000.0;
+}
+
+}
+
+// Drives SpeedReportingService against an in-process LocalMqttBroker at a
+// fixed sample rate and reports end-to-end latency from enqueueSpeed() to
+// the broker decoding the PUBLISH. Samples carry their sequence number as
+// the vehicle id and go out as binary payloads, so the broker side can
+// match every sample to its send time.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("MQTT reporting load test against a local broker");
+    parser.addHelpOption();
+    QCommandLineOption rateOption("rate", "Samples per second.", "samples", "20000");
+    QCommandLineOption durationOption("duration", "Seconds to generate load for.", "seconds", "5");
+    QCommandLineOption qosOption("qos", "Publish QoS: 0 or 1.", "qos", "0");
+    QCommandLineOption windowOption("window", "QoS 1 in-flight window.", "messages");
+    QCommandLineOption batchOption("batch", "Batch reports: samples, optionally samples:milliseconds.", "samples");
+    QCommandLineOption portOption("port", "Broker port (0 picks a free one).", "port", "0");
+    parser.addOption(rateOption);
+    parser.addOption(durationOption);
+    parser.addOption(qosOption);
+    parser.addOption(windowOption);
+    parser.addOption(batchOption);
+    parser.addOption(portOption);
+    parser.process(app);
+    
+    int rate = qMax(1, parser.value(rateOption).toInt());
+    double duration = qMax(0.1, parser.value(durationOption).toDouble());
+    int qos = parser.value(qosOption).toInt();
+    int total = int(rate * duration);
+    
+    LocalMqttBroker broker;
+    if (!broker.listen(QHostAddress::LocalHost, quint16(parser.value(portOption).toUInt()))) {
+        QTextStream(stderr) << "Cannot listen: " << broker.errorString() << "\n";
+        return 1;
+    }
+    
+    // Same arrangement as GameEngine: the service on its own thread, fed
+    // through its queue from this one
+    QThread reportingThread;
+    reportingThread.setObjectName("SpeedReporting");
+    SpeedReportingService *service = new SpeedReportingService();
+    service->moveToThread(&reportingThread);
+    QObject::connect(&reportingThread, &QThread::finished, service, &QObject::deleteLater);
+    reportingThread.start();
+    
+    QString endpoint = QString("127.0.0.1:%1").arg(broker.serverPort());
+    QMetaObject::invokeMethod(service, [&]() {
+        service->setPayloadFormat(TelemetryCodec::Format::Binary);
+        // Every sample is a new vehicle id; with nothing crossing the
+        // threshold they all take the throttled, batched path
+        service->setSpeedThreshold(1000.0);
+        service->setQos(qos);
+        if (parser.isSet(windowOption)) {
+            service->setInFlightWindow(parser.value(windowOption).toInt());
+        }
+        if (parser.isSet(batchOption)) {
+            QStringList limits = parser.value(batchOption).split(':');
+            service->setBatchLimits(limits.value(0).toInt(),
+                                    limits.size() > 1 ? limits[1].toInt() : service->batcher().maxLatency());
+            service->setBatchingEnabled(true);
+        }
+        service->startReporting(endpoint);
+    }, Qt::BlockingQueuedConnection);
+    
+    QElapsedTimer clock;
+    clock.start();
+    QVector<qint64> sentAt(total);
+    QVector<qint64> latencies;
+    latencies.reserve(total);
+    QVector<SpeedSample> decoded;
+    int sent = 0;
+    int dropped = 0;
+    
+    // Direct: the publish only points into the broker's receive buffer
+    QObject::connect(&broker, &LocalMqttBroker::publishReceived, &broker, [&](const MqttPublish &publish) {
+        qint64 now = clock.nsecsElapsed();
+        if (!TelemetryCodec::decodeBinary(publish.payload, publish.payloadSize, decoded)) {
+            return;
+        }
+        for (const SpeedSample &sample : decoded) {
+            if (sample.vehicleId >= 0 && sample.vehicleId < sent) {
+                latencies.append(now - sentAt[sample.vehicleId]);
+            }
+        }
+    }, Qt::DirectConnection);
+    
+    // Paced from a 1 ms timer: each tick sends whatever the rate says is due
+    qint64 loadStart = 0;
+    QTimer loadTimer;
+    loadTimer.setTimerType(Qt::PreciseTimer);
+    loadTimer.setInterval(1);
+    QObject::connect(&loadTimer, &QTimer::timeout, &loadTimer, [&]() {
+        qint64 due = qMin<qint64>(total, (clock.nsecsElapsed() - loadStart) * rate / 1000000000);
+        while (sent < due) {
+            sentAt[sent] = clock.nsecsElapsed();
+            if (!service->enqueueSpeed(sent, 80.0 + (sent & 63), QDateTime::currentMSecsSinceEpoch())) {
+                ++dropped;
+            }
+            ++sent;
+        }
+    
+        // Stop once everything has arrived, or after a grace period
+        bool finished = sent == total && latencies.size() >= sent - dropped;
+        bool timedOut = clock.nsecsElapsed() - loadStart > qint64((duration + 10.0) * 1e9);
+        if (finished || timedOut) {
+            loadTimer.stop();
+            app.quit();
+        }
+    });
+    
+    // SUBACK reaches the service just after the broker sends it; until then
+    // QoS 0 samples would go to the offline buffer
+    QObject::connect(&broker, &LocalMqttBroker::clientSubscribed, &broker, [&]() {
+        if (loadTimer.isActive() || sent > 0) {
+            return;
+        }
+        QTimer::singleShot(200, &loadTimer, [&]() {
+            loadStart = clock.nsecsElapsed();
+            loadTimer.start();
+        });
+    });
+    
+    QTimer::singleShot(10000, &app, [&]() {
+        if (!loadTimer.isActive() && sent == 0) {
+            QTextStream(stderr) << "Reporting service never subscribed to " << endpoint << "\n";
+            app.exit(1);
+        }
+    });
+    
+    int status = app.exec();
+    double seconds = (clock.nsecsElapsed() - loadStart) / 1e9;
+    
+    SpeedReportingService::QueueStats stats = service->queueStats();
+    QMetaObject::invokeMethod(service, &SpeedReportingService::stopReporting, Qt::BlockingQueuedConnection);
+    reportingThread.quit();
+    reportingThread.wait();
+    if (status != 0) {
+        return status;
+    }
+    
+    std::sort(latencies.begin(), latencies.end());
+    
+    QTextStream out(stdout);
+    out << "Samples sent:     " << sent << " @ " << rate << "/s, QoS " << qos << "\n";
+    out << "Samples received: " << latencies.size() << " in " << seconds << " s\n";
+    out << "Enqueue drops:    " << dropped << "\n";
+    out << "Enqueue latency:  " << (stats.enqueued > 0 ? stats.totalNanos / stats.enqueued : 0) << " ns mean, "
+        << stats.maxNanos << " ns max\n";
+    out << "Broker PUBLISHes: " << broker.publishesReceived() << ", " << broker.bytesReceived() << " bytes\n";
+    out << "Latency p50:      " << percentileMicros(latencies, 50.0) << " us\n";
+    out << "Latency p90:      " << percentileMicros(latencies, 90.0) << " us\n";
+    out << "Latency p99:      " << percentileMicros(latencies, 99.0) << " us\n";
+    out << "Latency p99.9:    " << percentileMicros(latencies, 99.9) << " us\n";
+    out << "Latency max:      " << percentileMicros(latencies, 100.0) << " us\n";
+    
+    return latencies.size() >= sent - dropped ? 0 : 2;
+}